@@ -22,46 +22,219 @@
 
 #ifdef HAVE_ANIMATION
 #include <glib.h>
+#include <string.h>
 
+typedef struct _AnimationInfo AnimationInfo;
 struct _AnimationInfo
 {
-	GTimer *timer;
-	
-	gdouble start_modifier;
-	gdouble stop_time;
+	gint64 start_time; /* monotonic time the animation started at */
+	gdouble duration;  /* in seconds, 0 for endless animations */
 	GtkWidget *widget;
+
+	gint64 interval;   /* microseconds between two frames */
+	gint64 next_frame; /* monotonic time of the next frame */
+
+	GdkRectangle damage; /* area to redraw, empty for the whole widget */
+
+	gboolean check_fade;   /* TRUE while the check mark fades in */
+	gint64 transition_end; /* monotonic time the last transition ends at */
+
+	/* progress bars report changes through signals instead of being
+	 * queried every tick */
+	gboolean progress;
+	gboolean stopped;
+	gdouble fraction;  /* fraction the bar was last drawn with */
+	gulong fraction_handler;
+	gulong map_handler;
+	gulong unmap_handler;
+
+	AnimationInfo *next_free;
 };
-typedef struct _AnimationInfo AnimationInfo;
+
+/* State of one transition, the value moves from 'from' towards 'target'
+ * along the easing curve of the transition type. */
+typedef struct
+{
+	gint64 start_time;
+	gdouble duration;
+	gdouble from;
+	gboolean target;
+} TransitionInfo;
 
 struct _SignalInfo
 {
 	GtkWidget *widget;
 	gulong handler_id;
+	GHashTable **table;
 };
 typedef struct _SignalInfo SignalInfo;
 
-static GSList     *connected_widgets  = NULL;
+struct _AnimationTick
+{
+	gint64 now;
+	gint64 next_deadline;
+	gint64 interval_scale; /* stretches the frame intervals under load */
+	guint  redraws;
+};
+typedef struct _AnimationTick AnimationTick;
+
+static GHashTable *connected_widgets  = NULL;
+static GHashTable *focus_widgets      = NULL; /* with a focus ring fade */
 static GHashTable *animated_widgets   = NULL;
+static GSList     *animation_slabs    = NULL;
+static AnimationInfo *free_animation_infos = NULL;
 static int         animation_timer_id = 0;
+static gint64      animation_timer_deadline = 0;
+static gint64      animation_frame_interval = 0;
+
+/* Animations read the time from a replaceable clock. The virtual clock
+ * only moves when it is told to, and ticks fire as it passes deadlines. */
+typedef gint64 (*AnimationClockFunc) (void);
+
+static AnimationClockFunc animation_clock = NULL;
+static gint64      virtual_clock_time = 0;
+static gint64      virtual_clock_deadline = G_MAXINT64;
+
+/* Degradation steps of the frame budget controller, each one includes
+ * the ones before it */
+enum
+{
+	ANIMATION_LEVEL_FULL,
+	ANIMATION_LEVEL_REDUCED_RATE, /* half the frame rate */
+	ANIMATION_LEVEL_VISIBLE_ONLY, /* skip widgets scrolled out of view */
+	ANIMATION_LEVEL_NO_FADES,     /* transitions jump to their end */
+	ANIMATION_NUM_LEVELS
+};
+
+static gint        animation_level = ANIMATION_LEVEL_FULL;
+static gint64      animation_budget = 0;
+static gboolean    frame_measuring = FALSE;
+static gint64      frame_draw_time = 0; /* spent in the engine's vfuncs */
+static guint       frame_idle_id = 0;
+static gint64      frame_cost = 0;      /* moving average, in microseconds */
+static gint64      frame_cost_peak = 0;
+static gint        frames_over_budget = 0;
+static gint        frames_under_budget = 0;
+
+/* rc styles sharing the state above, it is torn down with the last one */
+static guint       animation_users = 0;
 
 static gboolean animation_timeout_handler (gpointer data);
 
-/* This forces a redraw on a widget */
+static gdouble
+ease_in_out (gdouble t)
+{
+	return t * t * (3.0 - 2.0 * t);
+}
+
+static gdouble
+ease_out (gdouble t)
+{
+	return t * (2.0 - t);
+}
+
+/* pressing has to feel immediate, fades start and end softly */
+static gdouble (* const transition_easing[MRN_NUM_TRANSITIONS]) (gdouble t) =
+{
+	ease_in_out, /* MRN_TRANSITION_PRELIGHT */
+	ease_out,    /* MRN_TRANSITION_ACTIVE */
+	ease_in_out, /* MRN_TRANSITION_FOCUS */
+	ease_in_out  /* MRN_TRANSITION_SLIDER */
+};
+
+/* This forces a redraw of the animated area of a widget */
 static void
-force_widget_redraw (GtkWidget *widget)
+force_widget_redraw (AnimationInfo *animation_info)
 {
-	if (GTK_IS_PROGRESS_BAR (widget))
-		gtk_widget_queue_resize (widget);
+	GtkWidget *widget = animation_info->widget;
+
+	/* GtkProgressBar only repaints its offscreen pixmap when dirty */
+	if (animation_info->progress)
+		GTK_PROGRESS_BAR (widget)->dirty = TRUE;
+
+	if (animation_info->damage.width > 0 && animation_info->damage.height > 0)
+		gtk_widget_queue_draw_area (widget,
+		                            animation_info->damage.x, animation_info->damage.y,
+		                            animation_info->damage.width, animation_info->damage.height);
 	else
 		gtk_widget_queue_draw (widget);
 }
 
-/* ensures that the timer is running */
+/* returns the frame interval for smooth animations, in microseconds.
+ * The target frame rate can be set with XAMARIN_ANIMATION_FPS. */
+static gint64
+get_frame_interval ()
+{
+	if (animation_frame_interval == 0)
+	{
+		const gchar *env = g_getenv ("XAMARIN_ANIMATION_FPS");
+		gint64 fps = env ? g_ascii_strtoll (env, NULL, 10) : 0;
+
+		if (fps <= 0)
+			fps = ANIMATION_DEFAULT_FPS;
+
+		animation_frame_interval = G_USEC_PER_SEC / CLAMP (fps, 1, ANIMATION_MAX_FPS);
+	}
+
+	return animation_frame_interval;
+}
+
+static gint64
+virtual_clock_now ()
+{
+	return virtual_clock_time;
+}
+
+/* returns the clock of the animations. Setting XAMARIN_ANIMATION_CLOCK
+ * to "virtual" selects a clock that a test harness steps explicitly. */
+static AnimationClockFunc
+get_animation_clock ()
+{
+	if (animation_clock == NULL)
+	{
+		const gchar *env = g_getenv ("XAMARIN_ANIMATION_CLOCK");
+
+		if (env && strcmp (env, "virtual") == 0)
+			animation_clock = virtual_clock_now;
+		else
+			animation_clock = g_get_monotonic_time;
+	}
+
+	return animation_clock;
+}
+
+static gint64
+animation_clock_now ()
+{
+	return get_animation_clock () ();
+}
+
+/* ensures that the timer fires not later than deadline */
 static void
-start_timer ()
+schedule_timer (gint64 deadline)
 {
-	if (animation_timer_id == 0)
-		animation_timer_id = g_timeout_add (ANIMATION_DELAY, animation_timeout_handler, NULL);
+	gint64 now;
+
+	/* the virtual clock fires the tick when it is advanced */
+	if (get_animation_clock () == virtual_clock_now)
+	{
+		virtual_clock_deadline = MIN (virtual_clock_deadline, deadline);
+		return;
+	}
+
+	if (animation_timer_id != 0)
+	{
+		if (deadline >= animation_timer_deadline)
+			return;
+
+		g_source_remove (animation_timer_id);
+	}
+
+	now = g_get_monotonic_time ();
+
+	animation_timer_deadline = deadline;
+	animation_timer_id = g_timeout_add (deadline > now ? (deadline - now + 999) / 1000 : 0,
+	                                    animation_timeout_handler, NULL);
 }
 
 /* ensures that the timer is stopped */
@@ -76,12 +249,137 @@ stop_timer ()
 }
 
 
-/* destroys an AnimationInfo structure including the GTimer */
+/* returns the time a frame may take, in microseconds.
+ * It can be set with XAMARIN_ANIMATION_BUDGET. */
+static gint64
+get_frame_budget ()
+{
+	if (animation_budget == 0)
+	{
+		const gchar *env = g_getenv ("XAMARIN_ANIMATION_BUDGET");
+		gint64 budget = env ? g_ascii_strtoll (env, NULL, 10) : 0;
+
+		animation_budget = budget > 0 ? budget : ANIMATION_DEFAULT_BUDGET;
+	}
+
+	return animation_budget;
+}
+
+/* feeds the cost of a frame to the controller, which degrades the
+ * animations a step at a time while the average cost is over budget
+ * and recovers once it stays well below it */
+static void
+account_frame_cost (gint64 cost)
+{
+	gint64 budget = get_frame_budget ();
+
+	frame_cost = frame_cost ? (frame_cost * 7 + cost) / 8 : cost;
+	frame_cost_peak = MAX (frame_cost_peak, cost);
+
+	if (frame_cost > budget)
+	{
+		frames_under_budget = 0;
+		if (++frames_over_budget >= ANIMATION_BUDGET_FRAMES &&
+		    animation_level < ANIMATION_NUM_LEVELS - 1)
+		{
+			animation_level++;
+			frames_over_budget = 0;
+			g_debug ("animation frames take %" G_GINT64_FORMAT "us, over the budget of %" G_GINT64_FORMAT "us, degrading to level %d",
+			         frame_cost, budget, animation_level);
+		}
+	}
+	else if (frame_cost < budget / 2)
+	{
+		frames_over_budget = 0;
+		if (++frames_under_budget >= ANIMATION_BUDGET_FRAMES * 4 &&
+		    animation_level > ANIMATION_LEVEL_FULL)
+		{
+			animation_level--;
+			frames_under_budget = 0;
+		}
+	}
+	else
+	{
+		frames_over_budget = 0;
+		frames_under_budget = 0;
+	}
+}
+
+/* runs once the redraws queued by a tick have been painted, only the
+ * time spent painting in the engine counts against the budget, see
+ * murrine_animation_track_paint () */
+static gboolean
+frame_done_handler (gpointer data)
+{
+	frame_idle_id = 0;
+	frame_measuring = FALSE;
+	account_frame_cost (frame_draw_time);
+
+	return FALSE;
+}
+
+/* runs right before gdk paints the redraws queued by a tick */
+static gboolean
+frame_begin_handler (gpointer data)
+{
+	frame_measuring = TRUE;
+	frame_draw_time = 0;
+	frame_idle_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 1, frame_done_handler, NULL, NULL);
+
+	return FALSE;
+}
+
+/* takes an AnimationInfo structure from the free list, records are
+ * allocated ANIMATION_SLAB_SIZE at a time and never given back to malloc */
+static AnimationInfo*
+animation_info_new ()
+{
+	AnimationInfo *animation_info;
+
+	if (free_animation_infos == NULL)
+	{
+		AnimationInfo *slab = g_new (AnimationInfo, ANIMATION_SLAB_SIZE);
+		int i;
+
+		for (i = 0; i < ANIMATION_SLAB_SIZE; i++)
+		{
+			slab[i].next_free = free_animation_infos;
+			free_animation_infos = &slab[i];
+		}
+
+		animation_slabs = g_slist_prepend (animation_slabs, slab);
+	}
+
+	animation_info = free_animation_infos;
+	free_animation_infos = animation_info->next_free;
+
+	return animation_info;
+}
+
+/* puts an AnimationInfo structure back on the free list */
 static void
 animation_info_destroy (AnimationInfo *animation_info)
 {
-	g_timer_destroy (animation_info->timer);
-	g_free (animation_info);
+	animation_info->widget = NULL;
+	animation_info->next_free = free_animation_infos;
+	free_animation_infos = animation_info;
+}
+
+/* releases the slabs, all records have to be destroyed already */
+static void
+free_animation_slabs ()
+{
+	g_slist_foreach (animation_slabs, (GFunc) g_free, NULL);
+	g_slist_free (animation_slabs);
+	animation_slabs = NULL;
+	free_animation_infos = NULL;
+}
+
+/* returns the time elapsed since the start of the animation, in seconds */
+static gdouble
+animation_info_elapsed (const AnimationInfo *animation_info, gint64 now)
+{
+	return (gdouble)(now - animation_info->start_time) / G_USEC_PER_SEC;
 }
 
 /* This function does not unref the weak reference, because the object
@@ -104,8 +402,15 @@ destroy_animation_info_and_weak_unref (gpointer data)
 	
 	/* force a last redraw. This is so that if the animation is removed,
 	 * the widget is left in a sane state. */
-	force_widget_redraw (animation_info->widget);
+	force_widget_redraw (animation_info);
 	
+	if (animation_info->progress)
+	{
+		g_signal_handler_disconnect (animation_info->widget, animation_info->fraction_handler);
+		g_signal_handler_disconnect (animation_info->widget, animation_info->map_handler);
+		g_signal_handler_disconnect (animation_info->widget, animation_info->unmap_handler);
+	}
+
 	g_object_weak_unref (G_OBJECT (animation_info->widget), on_animated_widget_destruction, data);
 	animation_info_destroy (animation_info);
 }
@@ -121,88 +426,210 @@ lookup_animation_info (const GtkWidget *widget)
 }
 
 /* Create all the relevant information for the animation, and insert it into the hash table. */
-static void
-add_animation (const GtkWidget *widget, gdouble stop_time)
+static AnimationInfo*
+add_animation (const GtkWidget *widget, gdouble duration, gint64 interval)
 {
 	AnimationInfo *value;
 	
 	/* object already in the list, do not add it twice */
-	if (lookup_animation_info (widget))
-		return;
+	value = lookup_animation_info (widget);
+	if (value)
+		return value;
 	
 	if (animated_widgets == NULL)
 		animated_widgets = g_hash_table_new_full (g_direct_hash, g_direct_equal,
 		                                          NULL, destroy_animation_info_and_weak_unref);
 	
-	value = g_new(AnimationInfo, 1);
+	value = animation_info_new ();
 	
 	value->widget = (GtkWidget*) widget;
 	
-	value->timer = g_timer_new ();
-	value->stop_time= stop_time;
-	value->start_modifier = 0.0;
+	value->start_time = animation_clock_now ();
+	value->duration = duration;
+	value->interval = interval;
+	value->next_frame = value->start_time + interval;
+	value->damage.x = value->damage.y = 0;
+	value->damage.width = value->damage.height = 0;
+	value->check_fade = FALSE;
+	value->transition_end = 0;
+	value->progress = FALSE;
+	value->stopped = FALSE;
+	value->fraction = -1.0;
 
 	g_object_weak_ref (G_OBJECT (widget), on_animated_widget_destruction, value);
 	g_hash_table_insert (animated_widgets, (GtkWidget*) widget, value);
 	
-	start_timer ();
+	schedule_timer (value->next_frame);
+
+	return value;
+}
+
+/* makes sure the widget is redrawn every frame until end_time */
+static void
+keep_animating (GtkWidget *widget, gint64 end_time)
+{
+	AnimationInfo *animation_info = lookup_animation_info (widget);
+	gint64 now = animation_clock_now ();
+
+	if (animation_info == NULL)
+		animation_info = add_animation (widget, (gdouble)(end_time - now) / G_USEC_PER_SEC,
+		                                get_frame_interval ());
+	else if (animation_info->duration != 0)
+		animation_info->duration = MAX (animation_info->duration,
+		                                animation_info_elapsed (animation_info, end_time));
+
+	/* transitions change the whole widget */
+	animation_info->transition_end = MAX (animation_info->transition_end, end_time);
+	animation_info->damage.width = animation_info->damage.height = 0;
+}
+
+/* returns the current value of a transition, between 0 and 1 */
+static gdouble
+transition_value (const TransitionInfo *transition, MurrineTransitionType type, gint64 now)
+{
+	gdouble t = 1.0;
+
+	if (transition->duration > 0.0)
+		t = (gdouble)(now - transition->start_time) / G_USEC_PER_SEC / transition->duration;
+
+	if (t >= 1.0)
+		return transition->target ? 1.0 : 0.0;
+
+	return transition->from + ((transition->target ? 1.0 : 0.0) - transition->from) * transition_easing[type] (t);
+}
+
+/* returns TRUE if nobody can see the widget, even though it is drawable */
+static gboolean
+widget_is_hidden (GtkWidget *widget)
+{
+	GtkWidget *toplevel = gtk_widget_get_toplevel (widget);
+
+	if (toplevel->window == NULL)
+		return TRUE;
+
+	return (gdk_window_get_state (toplevel->window) &
+	        (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)) != 0;
+}
+
+/* returns TRUE if some of the widget is not clipped away by its parents,
+ * e.g. it is not scrolled out of view */
+static gboolean
+widget_is_on_screen (GtkWidget *widget)
+{
+	GdkRectangle area = widget->allocation;
+	GdkRegion *visible;
+	gboolean on_screen;
+
+	if (widget->window == NULL)
+		return FALSE;
+
+	/* the allocation is relative to the parent window */
+	if (gtk_widget_get_has_window (widget))
+		area.x = area.y = 0;
+
+	visible = gdk_drawable_get_visible_region (widget->window);
+	on_screen = gdk_region_rect_in (visible, &area) != GDK_OVERLAP_RECTANGLE_OUT;
+	gdk_region_destroy (visible);
+
+	return on_screen;
 }
 
 /* update the animation information for each widget. This will also queue a redraw
- * and stop the animation if it is done. */
+ * when the frame of the widget is due and stop the animation if it is done. */
 static gboolean
 update_animation_info (gpointer key, gpointer value, gpointer user_data)
 {
 	AnimationInfo *animation_info = value;
+	AnimationTick *tick = user_data;
 	GtkWidget *widget = key;
-	gdouble elapsed;
 	
 	if ((widget == NULL) || (animation_info == NULL))
 		g_assert_not_reached ();
 	
-	/* remove the widget from the hash table if it is not drawable */
-	if (!GTK_WIDGET_DRAWABLE (widget))
-		return TRUE;
-	
-	if (GTK_IS_PROGRESS_BAR (widget))
+	/* remove the widget from the hash table if it is not drawable, or
+	 * is a filled/not filled progress bar */
+	if (animation_info->progress)
 	{
-		gfloat fraction = gtk_progress_bar_get_fraction (GTK_PROGRESS_BAR (widget));
-		
-		/* stop animation for filled/not filled progress bars */
-		if (fraction <= 0.0 || fraction >= 1.0)
+		if (animation_info->stopped)
 			return TRUE;
 	}
+	else if (!GTK_WIDGET_DRAWABLE (widget))
+		return TRUE;
 	
-	force_widget_redraw (widget);
+	if (animation_info->next_frame <= tick->now)
+	{
+		gint64 interval = animation_info->interval * tick->interval_scale;
+
+		if (widget_is_hidden (widget))
+		{
+			/* only check now and then whether the window came back */
+			animation_info->next_frame = tick->now + ANIMATION_IDLE_DELAY * 1000;
+		}
+		else
+		{
+			if (animation_level < ANIMATION_LEVEL_VISIBLE_ONLY || widget_is_on_screen (widget))
+			{
+				force_widget_redraw (animation_info);
+				tick->redraws++;
+			}
+
+			/* stay on the frame grid, frames we are late for are dropped */
+			animation_info->next_frame += interval;
+			if (animation_info->next_frame <= tick->now)
+				animation_info->next_frame = tick->now + interval -
+				                             (tick->now - animation_info->next_frame) % interval;
+		}
+	}
 	
-	/* stop at stop_time */
-	if (animation_info->stop_time != 0 &&
-	    g_timer_elapsed (animation_info->timer, NULL) > animation_info->stop_time)
+	/* stop once the duration is over */
+	if (animation_info->duration != 0 &&
+	    animation_info_elapsed (animation_info, tick->now) > animation_info->duration)
 		return TRUE;
 	
+	tick->next_deadline = MIN (tick->next_deadline, animation_info->next_frame);
+
 	return FALSE;
 }
 
-/* This gets called by the glib main loop every once in a while. */
+/* advances all animations to now, queueing the redraws that are due */
+static void
+animation_tick (gint64 now)
+{
+	AnimationTick tick;
+
+	/*g_print("** TICK **\n");*/
+	tick.now = now;
+	tick.next_deadline = G_MAXINT64;
+	tick.redraws = 0;
+
+	/* every widget gets its share of the redraws a frame may do */
+	tick.interval_scale = 1 + (g_hash_table_size (animated_widgets) - 1) / ANIMATION_MAX_WIDGETS_PER_FRAME;
+	if (animation_level >= ANIMATION_LEVEL_REDUCED_RATE)
+		tick.interval_scale *= 2;
+
+	g_hash_table_foreach_remove (animated_widgets, update_animation_info, &tick);
+
+	/* measure how long painting the queued redraws takes, a virtual
+	 * clock keeps the animations deterministic instead */
+	if (tick.redraws > 0 && frame_idle_id == 0 && get_animation_clock () != virtual_clock_now)
+		frame_idle_id = g_idle_add_full (GDK_PRIORITY_REDRAW - 1, frame_begin_handler, NULL, NULL);
+	
+	if (g_hash_table_size (animated_widgets) > 0)
+		schedule_timer (tick.next_deadline);
+}
+
+/* This gets called by the glib main loop when the earliest frame is due. */
 static gboolean
 animation_timeout_handler (gpointer data)
 {
+	animation_timer_id = 0;
+
 	/* enter threads as update_animation_info will use gtk/gdk. */
 	gdk_threads_enter ();
-
-	/*g_print("** TICK **\n");*/
-	g_hash_table_foreach_remove (animated_widgets, update_animation_info, NULL);
-	
-	/* leave again */
+	animation_tick (animation_clock_now ());
 	gdk_threads_leave ();
 	
-	if(g_hash_table_size(animated_widgets)==0)
-	{
-		stop_timer ();
-		return FALSE;
-	}
-	
-	return TRUE;
+	return FALSE;
 }
 
 static void
@@ -210,91 +637,340 @@ on_checkbox_toggle (GtkWidget *widget, gpointer data)
 {
 	AnimationInfo *animation_info = lookup_animation_info (widget);
 	
+	if (animation_level >= ANIMATION_LEVEL_NO_FADES)
+		return;
+
 	if (animation_info != NULL)
 	{
-		gfloat elapsed = g_timer_elapsed (animation_info->timer, NULL);
-		
-		animation_info->start_modifier = elapsed - animation_info->start_modifier;
+		gint64 now = animation_clock_now ();
+
+		/* toggled again while animating, restart the fade for the new state */
+		animation_info->start_time = now;
+		animation_info->duration = MAX (CHECK_ANIMATION_TIME,
+		                                (gdouble)(animation_info->transition_end - now) / G_USEC_PER_SEC);
 	}
 	else
 	{
-		add_animation (widget, CHECK_ANIMATION_TIME);
+		animation_info = add_animation (widget, CHECK_ANIMATION_TIME, get_frame_interval ());
 	}
+
+	animation_info->check_fade = TRUE;
+}
+
+/* progress bars are only animated while partially filled */
+static gboolean
+progressbar_is_stopped (GtkWidget *widget)
+{
+	gdouble fraction = gtk_progress_bar_get_fraction (GTK_PROGRESS_BAR (widget));
+
+	return fraction <= 0.0 || fraction >= 1.0 || !GTK_WIDGET_DRAWABLE (widget);
+}
+
+static void
+on_progressbar_changed (GtkWidget *widget, gpointer data)
+{
+	AnimationInfo *animation_info = data;
+
+	animation_info->stopped = progressbar_is_stopped (widget);
+}
+
+static void
+on_progressbar_notify (GObject *object, GParamSpec *pspec, gpointer data)
+{
+	on_progressbar_changed (GTK_WIDGET (object), data);
+}
+
+static void
+on_progressbar_unmap (GtkWidget *widget, gpointer data)
+{
+	AnimationInfo *animation_info = data;
+
+	animation_info->stopped = TRUE;
+}
+
+/* the focus ring is not drawn without the focus, rewind its fade */
+static gboolean
+on_focus_out (GtkWidget *widget, GdkEventFocus *event, gpointer data)
+{
+	murrine_animation_transition (widget, MRN_TRANSITION_FOCUS, FALSE, 0.0);
+
+	return FALSE;
 }
 
 static void
 on_connected_widget_destruction (gpointer data, GObject *widget)
 {
-	connected_widgets = g_slist_remove (connected_widgets, data);
-	g_free (data);
+	SignalInfo *signal_info = (SignalInfo*) data;
+
+	g_hash_table_remove (*signal_info->table, widget);
+	g_free (signal_info);
 }
 
+/* connects a handler to the widget once per table, the handlers are
+ * disconnected along with the table in disconnect_all_signals () */
 static void
-disconnect_all_signals ()
+connect_widget_signal (GHashTable **table, GtkWidget *widget,
+                       const gchar *signal, GCallback callback)
+{
+	SignalInfo *signal_info;
+
+	if (*table == NULL)
+		*table = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	if (g_hash_table_lookup (*table, widget))
+		return;
+
+	signal_info = g_new (SignalInfo, 1);
+	signal_info->widget = widget;
+	signal_info->handler_id = g_signal_connect ((GObject*)widget, signal, callback, NULL);
+	signal_info->table = table;
+
+	g_hash_table_insert (*table, widget, signal_info);
+	g_object_weak_ref (G_OBJECT (widget), on_connected_widget_destruction, signal_info);
+}
+
+static void
+disconnect_signals (GHashTable **table)
 {
-	GSList * item = connected_widgets;
-	while (item != NULL)
+	GHashTableIter iter;
+	gpointer value;
+
+	if (*table == NULL)
+		return;
+
+	g_hash_table_iter_init (&iter, *table);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
 	{
-		SignalInfo *signal_info = (SignalInfo*) item->data;
+		SignalInfo *signal_info = (SignalInfo*) value;
 		
 		g_signal_handler_disconnect (signal_info->widget, signal_info->handler_id);
 		g_object_weak_unref (G_OBJECT (signal_info->widget), on_connected_widget_destruction, signal_info);
 		g_free (signal_info);
-		
-		item = g_slist_next (item);
 	}
 	
-	g_slist_free (connected_widgets);
-	connected_widgets = NULL;
+	g_hash_table_destroy (*table);
+	*table = NULL;
 }
 
-/* helper function for murrine_animation_connect_checkbox */
-static gint
-find_signal_info (gconstpointer signal_info, gconstpointer widget)
+static void
+disconnect_all_signals ()
 {
-	if (((SignalInfo*)signal_info)->widget == widget)
-		return 0;
-	else
-		return 1;
+	disconnect_signals (&connected_widgets);
+	disconnect_signals (&focus_widgets);
 }
 
 
 /* external interface */
 
-/* adds a progress bar */
+/* hooks up the signals for check and radio buttons */
 void
-murrine_animation_progressbar_add (GtkWidget *progressbar)
+murrine_animation_connect_checkbox (GtkWidget *widget)
 {
-	gdouble fraction = gtk_progress_bar_get_fraction (GTK_PROGRESS_BAR (progressbar));
-	
-	if (fraction < 1.0 && fraction > 0.0)
-		add_animation ((GtkWidget*) progressbar, 0.0);
+	if (GTK_IS_CHECK_BUTTON (widget))
+		connect_widget_signal (&connected_widgets, widget, "toggled", G_CALLBACK (on_checkbox_toggle));
 }
 
-/* hooks up the signals for check and radio buttons */
+/* records the area an animated widget draws its animation on, in the
+ * coordinates of the drawable it is painted on */
+static void
+animation_info_set_damage (AnimationInfo *animation_info, GdkDrawable *window,
+                           gint x, gint y, gint width, gint height)
+{
+	GtkWidget *widget = animation_info->widget;
+	GdkRectangle *damage = &animation_info->damage;
+
+	/* the whole widget is redrawn while a transition runs */
+	if (animation_info->transition_end > animation_clock_now ())
+		return;
+
+	/* progress bars paint on an offscreen pixmap matching their window */
+	if (window != widget->window &&
+	    !(animation_info->progress && window == GTK_PROGRESS (widget)->offscreen_pixmap))
+	{
+		/* e.g. cells of a tree view, fall back to the whole widget */
+		damage->width = damage->height = 0;
+		return;
+	}
+
+	damage->x = x;
+	damage->y = y;
+	damage->width = width;
+	damage->height = height;
+
+	/* gtk_widget_queue_draw_area () expects allocation coordinates */
+	if (gtk_widget_get_has_window (widget) && widget->window)
+	{
+		gint wx, wy;
+
+		gdk_window_get_position (widget->window, &wx, &wy);
+		damage->x += wx;
+		damage->y += wy;
+	}
+}
+
+/* animates a partially filled progress bar, painted at the given area,
+ * and returns the elapsed time of its animation */
+gdouble
+murrine_animation_progressbar_update (GtkWidget *progressbar, GdkDrawable *window,
+                                      gint x, gint y, gint width, gint height)
+{
+	AnimationInfo *animation_info = lookup_animation_info (progressbar);
+	gdouble fraction;
+
+	if (animation_info == NULL)
+	{
+		if (progressbar_is_stopped (progressbar))
+			return 0.0;
+
+		animation_info = add_animation (progressbar, 0.0,
+		                                MAX (ANIMATION_DELAY * 1000, get_frame_interval ()));
+	}
+
+	if (!animation_info->progress)
+	{
+		animation_info->progress = TRUE;
+		animation_info->fraction_handler = g_signal_connect (progressbar, "notify::fraction",
+		                                                     G_CALLBACK (on_progressbar_notify), animation_info);
+		animation_info->map_handler = g_signal_connect (progressbar, "map",
+		                                                G_CALLBACK (on_progressbar_changed), animation_info);
+		animation_info->unmap_handler = g_signal_connect (progressbar, "unmap",
+		                                                  G_CALLBACK (on_progressbar_unmap), animation_info);
+	}
+
+	/* bars driven through the GtkProgress adjustment never notify
+	 * "fraction", catch their changes when they are drawn */
+	fraction = gtk_progress_bar_get_fraction (GTK_PROGRESS_BAR (progressbar));
+	if (fraction != animation_info->fraction)
+	{
+		animation_info->fraction = fraction;
+		on_progressbar_changed (progressbar, animation_info);
+	}
+
+	animation_info_set_damage (animation_info, window, x, y, width, height);
+
+	return animation_info_elapsed (animation_info, animation_clock_now ());
+}
+
+/* records the damage of an animated widget, see animation_info_set_damage () */
 void
-murrine_animation_connect_checkbox (GtkWidget *widget)
+murrine_animation_set_damage (GtkWidget *widget, GdkDrawable *window,
+                              gint x, gint y, gint width, gint height)
 {
-	if (GTK_IS_CHECK_BUTTON (widget))
+	AnimationInfo *animation_info = lookup_animation_info (widget);
+
+	if (animation_info != NULL)
+		animation_info_set_damage (animation_info, window, x, y, width, height);
+}
+
+/* moves a transition of the widget towards target and returns its eased
+ * value, 0 when settled on FALSE and 1 when settled on TRUE. Widgets start
+ * settled on FALSE, a reversed transition only covers the remaining way. */
+gdouble
+murrine_animation_transition (GtkWidget *widget, MurrineTransitionType type,
+                              gboolean target, gdouble duration)
+{
+	static GQuark quark = 0;
+	TransitionInfo *transitions;
+	TransitionInfo *transition;
+	gint64 now, end_time;
+	gdouble value;
+
+	if (!quark)
+		quark = g_quark_from_static_string ("murrine-transitions");
+
+	transitions = g_object_get_qdata (G_OBJECT (widget), quark);
+	if (transitions == NULL)
 	{
-		if (!g_slist_find_custom (connected_widgets, widget, find_signal_info))
-		{
-			SignalInfo * signal_info = g_new (SignalInfo, 1);
-			
-			signal_info->widget = widget;
-			signal_info->handler_id = g_signal_connect ((GObject*)widget, "toggled", G_CALLBACK (on_checkbox_toggle), NULL);
-			
-			connected_widgets = g_slist_append (connected_widgets, signal_info);
-			g_object_weak_ref (G_OBJECT (widget), on_connected_widget_destruction, signal_info);
-		}
+		if (!target)
+			return 0.0;
+
+		transitions = g_new0 (TransitionInfo, MRN_NUM_TRANSITIONS);
+		g_object_set_qdata_full (G_OBJECT (widget), quark, transitions, g_free);
+	}
+
+	transition = &transitions[type];
+	now = animation_clock_now ();
+
+	/* rather than checking the focus of every widget drawn */
+	if (type == MRN_TRANSITION_FOCUS && target && !transition->target)
+		connect_widget_signal (&focus_widgets, widget, "focus-out-event", G_CALLBACK (on_focus_out));
+
+	/* over budget, the transition just finishes */
+	if (animation_level >= ANIMATION_LEVEL_NO_FADES)
+	{
+		transition->target = target;
+		transition->duration = 0.0;
+	}
+
+	value = transition_value (transition, type, now);
+
+	if (transition->target != target)
+	{
+		transition->start_time = now;
+		transition->duration = duration * (target ? 1.0 - value : value);
+		transition->from = value;
+		transition->target = target;
+
+		value = transition_value (transition, type, now);
 	}
+
+	end_time = transition->start_time + (gint64)(transition->duration * G_USEC_PER_SEC);
+	if (end_time > now)
+		keep_animating (widget, end_time);
+
+	return value;
 }
 
-/* returns TRUE if the widget is animated, and FALSE otherwise */
+/* returns TRUE if the check mark of the widget is fading in, and FALSE otherwise */
 gboolean
 murrine_animation_is_animated (GtkWidget *widget)
 {
-	return lookup_animation_info (widget) != NULL ? TRUE : FALSE;
+	AnimationInfo *animation_info = lookup_animation_info (widget);
+
+	return animation_info != NULL && animation_info->check_fade &&
+	       animation_level < ANIMATION_LEVEL_NO_FADES ? TRUE : FALSE;
+}
+
+/* returns the moving average and the peak of the time animation frames
+ * take to paint, the budget for them and the current degradation level */
+void
+murrine_animation_get_stats (gint64 *cost, gint64 *peak_cost,
+                             gint64 *budget, gint *level)
+{
+	if (cost)
+		*cost = frame_cost;
+	if (peak_cost)
+		*peak_cost = frame_cost_peak;
+	if (budget)
+		*budget = get_frame_budget ();
+	if (level)
+		*level = animation_level;
+}
+
+static void
+paint_done (void *data)
+{
+	gint64 *start = data;
+
+	if (frame_measuring)
+		frame_draw_time += g_get_monotonic_time () - *start;
+	g_free (start);
+}
+
+/* accounts the time until cr is destroyed to the frame being measured,
+ * the style vfuncs paint through one context each */
+void
+murrine_animation_track_paint (cairo_t *cr)
+{
+	static cairo_user_data_key_t key;
+	gint64 *start;
+
+	if (!frame_measuring)
+		return;
+
+	start = g_new (gint64, 1);
+	*start = g_get_monotonic_time ();
+	cairo_set_user_data (cr, &key, start, paint_done);
 }
 
 /* returns the elapsed time for the animation */
@@ -304,16 +980,49 @@ murrine_animation_elapsed (gpointer data)
 	AnimationInfo *animation_info = lookup_animation_info (data);
 	
 	if (animation_info)
-		return   g_timer_elapsed (animation_info->timer, NULL)
-		       - animation_info->start_modifier;
+		return animation_info_elapsed (animation_info, animation_clock_now ());
 	else
 		return 0.0;
 }
 
+/* moves the virtual clock forward to time, in microseconds, running the
+ * tick when a frame is due. The redraws it queues are painted by the main
+ * loop as usual. Returns FALSE if the animations use the real clock. */
+gboolean
+murrine_animation_set_clock (gint64 time)
+{
+	if (get_animation_clock () != virtual_clock_now)
+		return FALSE;
+
+	virtual_clock_time = MAX (virtual_clock_time, time);
+
+	if (animated_widgets != NULL && virtual_clock_deadline <= virtual_clock_time)
+	{
+		virtual_clock_deadline = G_MAXINT64;
+		animation_tick (virtual_clock_time);
+	}
+
+	return TRUE;
+}
+
+/* advances the virtual clock by delta microseconds, see above */
+gboolean
+murrine_animation_advance_clock (gint64 delta)
+{
+	return murrine_animation_set_clock (virtual_clock_time + MAX (delta, 0));
+}
+
 /* cleans up all resources of the animation system */
 void
 murrine_animation_cleanup ()
 {
+	stop_timer ();
+
+	if (frame_idle_id != 0)
+	{
+		g_source_remove (frame_idle_id);
+		frame_idle_id = 0;
+	}
 	disconnect_all_signals ();
 	
 	if (animated_widgets != NULL)
@@ -322,7 +1031,39 @@ murrine_animation_cleanup ()
 		animated_widgets = NULL;
 	}
 	
-	stop_timer ();
+	free_animation_slabs ();
+
+	/* pick up changed settings with the next theme, which starts
+	 * out at full animation */
+	animation_frame_interval = 0;
+	animation_budget = 0;
+	animation_level = ANIMATION_LEVEL_FULL;
+	frame_measuring = FALSE;
+	frame_draw_time = 0;
+	frame_cost = 0;
+	frame_cost_peak = 0;
+	frames_over_budget = 0;
+	frames_under_budget = 0;
+	animation_clock = NULL;
+	virtual_clock_deadline = G_MAXINT64;
+}
+
+/* Every live rc style holds a reference on the animation state, so that
+ * reparsing the rc files or dropping a transient style leaves running
+ * animations and connected checkboxes alone. */
+void
+murrine_animation_ref ()
+{
+	animation_users++;
+}
+
+void
+murrine_animation_unref ()
+{
+	g_return_if_fail (animation_users > 0);
+
+	if (--animation_users == 0)
+		murrine_animation_cleanup ();
 }
 
 #endif /* HAVE_ANIMATION */
@@ -23,13 +23,34 @@
 #ifdef HAVE_ANIMATION
 #include <gtk/gtk.h>
 
+#include "murrine_types.h"
+
 /* #define MRN_IS_PROGRESS_BAR(widget) GTK_IS_PROGRESS_BAR(widget) && widget->allocation.x != -1 && widget->allocation.y != -1 */
 #define ANIMATION_DELAY 100
+#define ANIMATION_IDLE_DELAY 1000
+#define ANIMATION_DEFAULT_FPS 30
+#define ANIMATION_MAX_FPS 240
+#define ANIMATION_SLAB_SIZE 32
+#define ANIMATION_DEFAULT_BUDGET 4000
+#define ANIMATION_BUDGET_FRAMES 8
+#define ANIMATION_MAX_WIDGETS_PER_FRAME 16
 #define CHECK_ANIMATION_TIME 0.5
 
-G_GNUC_INTERNAL void murrine_animation_progressbar_add (GtkWidget *progressbar);
+G_GNUC_INTERNAL gdouble murrine_animation_progressbar_update (GtkWidget *progressbar, GdkDrawable *window,
+                                                              gint x, gint y, gint width, gint height);
 G_GNUC_INTERNAL void murrine_animation_connect_checkbox (GtkWidget *widget);
+G_GNUC_INTERNAL void murrine_animation_set_damage (GtkWidget *widget, GdkDrawable *window,
+                                                   gint x, gint y, gint width, gint height);
+G_GNUC_INTERNAL gdouble murrine_animation_transition (GtkWidget *widget, MurrineTransitionType type,
+                                                      gboolean target, gdouble duration);
 G_GNUC_INTERNAL gboolean murrine_animation_is_animated (GtkWidget *widget);
 G_GNUC_INTERNAL gdouble murrine_animation_elapsed (gpointer data);
+G_GNUC_INTERNAL void murrine_animation_track_paint (cairo_t *cr);
+G_GNUC_INTERNAL void murrine_animation_get_stats (gint64 *cost, gint64 *peak_cost,
+                                                  gint64 *budget, gint *level);
+G_GNUC_INTERNAL gboolean murrine_animation_set_clock (gint64 time);
+G_GNUC_INTERNAL gboolean murrine_animation_advance_clock (gint64 delta);
 G_GNUC_INTERNAL void murrine_animation_cleanup ();
+G_GNUC_INTERNAL void murrine_animation_ref ();
+G_GNUC_INTERNAL void murrine_animation_unref ();
 #endif /* HAVE_ANIMATION */
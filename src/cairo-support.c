@@ -24,6 +24,7 @@
 #include "support.h"
 #include "murrine_types.h"
 #include "raico-blur.h"
+#include "raster-cache.h"
 
 G_GNUC_INTERNAL void
 murrine_rgb_to_hls (gdouble *r,
@@ -678,25 +679,41 @@ murrine_draw_blur_glow (cairo_t *cr,
                         int x, int y, int width, int height,
                         int roundness, uint8 corners)
 {
-	raico_blur_t* blur = NULL;
-	cairo_t *cr_surface; 
+	MurrineRasterKey key;
 	cairo_surface_t *surface;
 	double bradius = 6;
+	double scale = murrine_get_device_scale (cr);
 
-	/* draw glow */
-	surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width+bradius*2, height+bradius*2);
-	cr_surface = cairo_create (surface); 
-	blur = raico_blur_create (RAICO_BLUR_QUALITY_LOW);
-	raico_blur_set_radius (blur, bradius);
-	cairo_set_line_width (cr_surface, 4.0);
-	murrine_rounded_rectangle_closed (cr_surface, bradius, bradius, width, height, roundness, corners);
-	murrine_set_color_rgb (cr_surface, glow);
-	cairo_stroke (cr_surface);
-	raico_blur_apply (blur, surface);
-	cairo_set_source_surface (cr, surface, -bradius+2, -bradius+2); 
+	murrine_raster_key_init (&key, MRN_RASTER_BLUR_GLOW, width, height, scale);
+	key.param[0] = roundness;
+	key.param[1] = corners;
+	key.color[0] = *glow;
+
+	surface = murrine_raster_cache_lookup (&key);
+	if (!surface)
+	{
+		raico_blur_t* blur = NULL;
+		cairo_t *cr_surface;
+
+		/* draw glow */
+		surface = murrine_raster_surface_create (width+bradius*2, height+bradius*2, key.scale);
+		cr_surface = cairo_create (surface);
+		blur = raico_blur_create (RAICO_BLUR_QUALITY_LOW);
+		raico_blur_set_radius (blur, bradius*key.scale);
+		cairo_set_line_width (cr_surface, 4.0);
+		murrine_rounded_rectangle_closed (cr_surface, bradius, bradius, width, height, roundness, corners);
+		murrine_set_color_rgb (cr_surface, glow);
+		cairo_stroke (cr_surface);
+		raico_blur_apply (blur, surface);
+		raico_blur_destroy (blur);
+		cairo_destroy (cr_surface);
+
+		murrine_raster_cache_insert (&key, surface);
+	}
+
+	cairo_set_source_surface (cr, surface, -bradius+2, -bradius+2);
 	cairo_paint (cr);
-	cairo_surface_destroy (surface); 
-	cairo_destroy (cr_surface); 
+	cairo_surface_destroy (surface);
 }
 
 static void
@@ -1280,3 +1297,106 @@ murrine_get_inverted_gradient_shades (MurrineGradients mrn_gradient)
 
 	return mrn_gradient_new;
 }
+
+/* Blurred glow used by menustyle 2 and 3, drawn from the menu origin */
+void
+murrine_draw_menu_glow (cairo_t *cr,
+                        const MurrineRGB *fill,
+                        const MurrineRGB *bg,
+                        int width, int height)
+{
+	MurrineRasterKey key;
+	cairo_surface_t *surface;
+	int bradius = 30;
+	int bheight = MIN (height, 300);
+	double scale = murrine_get_device_scale (cr);
+
+	murrine_raster_key_init (&key, MRN_RASTER_MENU_GLOW, width, bheight, scale);
+	key.color[0] = *fill;
+	key.color[1] = *bg;
+
+	surface = murrine_raster_cache_lookup (&key);
+	if (!surface)
+	{
+		raico_blur_t* blur = NULL;
+		cairo_t *cr_surface;
+		cairo_pattern_t *pat;
+
+		surface = murrine_raster_surface_create (width, bheight, key.scale);
+		cr_surface = cairo_create (surface);
+		blur = raico_blur_create (RAICO_BLUR_QUALITY_LOW);
+		raico_blur_set_radius (blur, bradius*key.scale);
+		cairo_set_line_width (cr_surface, 1.0);
+		cairo_rectangle (cr_surface, bradius, bradius-15, width-bradius*2, bheight-bradius*2+15);
+		murrine_set_color_rgb (cr_surface, fill);
+		cairo_fill (cr_surface);
+		raico_blur_apply (blur, surface);
+		raico_blur_destroy (blur);
+		cairo_rectangle (cr_surface, 0, -15, width, bheight+15);
+		pat = cairo_pattern_create_linear (0, -15, 0.0, bheight+15);
+		murrine_pattern_add_color_stop_rgba (pat, 0.25, bg, 0.0);
+		murrine_pattern_add_color_stop_rgba (pat, 1.0, bg, 1.0);
+		cairo_set_source (cr_surface, pat);
+		cairo_pattern_destroy (pat);
+		cairo_fill (cr_surface);
+		cairo_destroy (cr_surface);
+
+		murrine_raster_cache_insert (&key, surface);
+	}
+
+	cairo_set_source_surface (cr, surface, 0, 0);
+	cairo_paint (cr);
+	cairo_surface_destroy (surface);
+}
+
+/* Diagonal progressbar strokes. The tile only depends on the height and
+ * color, animation frames just shift the pattern by x_step. */
+void
+murrine_draw_progressbar_strokes (cairo_t *cr,
+                                  const MurrineRGB *effect,
+                                  int width, int height,
+                                  int x_step)
+{
+	MurrineRasterKey key;
+	cairo_surface_t *surface;
+	cairo_pattern_t *pat;
+	cairo_matrix_t   matrix;
+	int stroke_width = height*2;
+
+	if (stroke_width <= 0)
+		return;
+
+	murrine_raster_key_init (&key, MRN_RASTER_PROGRESSBAR_STROKES, stroke_width, height,
+	                         murrine_get_device_scale (cr));
+	key.color[0] = *effect;
+
+	surface = murrine_raster_cache_lookup (&key);
+	if (!surface)
+	{
+		cairo_t *cr_surface;
+
+		surface = murrine_raster_surface_create (stroke_width, height, key.scale);
+		cr_surface = cairo_create (surface);
+		cairo_move_to (cr_surface, stroke_width/2.0, 0);
+		cairo_line_to (cr_surface, stroke_width, 0);
+		cairo_line_to (cr_surface, stroke_width/2.0, height);
+		cairo_line_to (cr_surface, 0, height);
+		murrine_set_color_rgba (cr_surface, effect, 0.15);
+		cairo_fill (cr_surface);
+		cairo_destroy (cr_surface);
+
+		murrine_raster_cache_insert (&key, surface);
+	}
+
+	pat = cairo_pattern_create_for_surface (surface);
+	cairo_surface_destroy (surface);
+	cairo_pattern_set_extend (pat, CAIRO_EXTEND_REPEAT);
+	cairo_matrix_init_translate (&matrix, x_step, 0);
+	cairo_pattern_set_matrix (pat, &matrix);
+
+	cairo_set_source (cr, pat);
+	cairo_pattern_destroy (pat);
+
+	cairo_rectangle (cr, 0, 0, width, height);
+	cairo_fill (cr);
+}
@@ -165,3 +165,13 @@ G_GNUC_INTERNAL void murrine_draw_glaze (cairo_t *cr,
                                          int x, int y, int width, int height,
                                          int radius, uint8 corners, boolean horizontal);
 
+
+G_GNUC_INTERNAL void murrine_draw_menu_glow (cairo_t *cr,
+                                             const MurrineRGB *fill,
+                                             const MurrineRGB *bg,
+                                             int width, int height);
+
+G_GNUC_INTERNAL void murrine_draw_progressbar_strokes (cairo_t *cr,
+                                                       const MurrineRGB *effect,
+                                                       int width, int height,
+                                                       int x_step);
@@ -0,0 +1,257 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <string.h>
+
+#include "display-list.h"
+#include "support.h"
+#include "trace.h"
+
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 10, 0)
+#define HAVE_RECORDING_SURFACE 1
+#endif
+
+#define DISPLAY_LIST_MAX_ENTRIES 128
+
+struct _MurrineDisplayLists
+{
+	GHashTable *table;
+
+	/* The primitive currently being recorded */
+	MurrineDisplayListKey pending;
+	cairo_surface_t      *recording;
+	int                   x;
+	int                   y;
+};
+
+/* Copies only the fields that are meaningful for the given parameters,
+ * so that unused members and padding never take part in the comparison. */
+static void
+murrine_display_list_key_init (MurrineDisplayListKey  *key,
+                               MurrineDisplayListType  type,
+                               const WidgetParameters *widget,
+                               int width, int height)
+{
+	const MurrineGradients *src = &widget->mrn_gradient;
+	MurrineGradients *dst = &key->widget.mrn_gradient;
+	int i;
+
+	memset (key, 0, sizeof (MurrineDisplayListKey));
+
+	key->type   = type;
+	key->width  = width;
+	key->height = height;
+
+	key->widget.active            = widget->active;
+	key->widget.prelight          = widget->prelight;
+	key->widget.disabled          = widget->disabled;
+	key->widget.ltr               = widget->ltr;
+	key->widget.focus             = widget->focus;
+	key->widget.is_default        = widget->is_default;
+	key->widget.state_type        = widget->state_type;
+	key->widget.corners           = widget->corners;
+	key->widget.xthickness        = widget->xthickness;
+	key->widget.ythickness        = widget->ythickness;
+	key->widget.parentbg          = widget->parentbg;
+	key->widget.glazestyle        = widget->glazestyle;
+	key->widget.glowstyle         = widget->glowstyle;
+	key->widget.lightborderstyle  = widget->lightborderstyle;
+	key->widget.reliefstyle       = widget->reliefstyle;
+	key->widget.roundness         = widget->roundness;
+	key->widget.contrast          = widget->contrast;
+	key->widget.glow_shade        = widget->glow_shade;
+	key->widget.highlight_shade   = widget->highlight_shade;
+	key->widget.lightborder_shade = widget->lightborder_shade;
+	key->widget.style             = widget->style;
+
+	for (i = 0; i < 2; i++)
+	{
+		dst->border_shades[i]        = src->border_shades[i];
+		dst->shadow_shades[i]        = src->shadow_shades[i];
+		dst->trough_border_shades[i] = src->trough_border_shades[i];
+		dst->trough_shades[i]        = src->trough_shades[i];
+		if (src->has_border_colors)
+			dst->border_colors[i] = src->border_colors[i];
+	}
+	for (i = 0; i < 4; i++)
+	{
+		dst->gradient_shades[i] = src->gradient_shades[i];
+		if (src->has_gradient_colors)
+			dst->gradient_colors[i] = src->gradient_colors[i];
+	}
+	dst->rgba_opacity        = src->rgba_opacity;
+	dst->has_border_colors   = src->has_border_colors;
+	dst->gradients           = src->gradients;
+	dst->has_gradient_colors = src->has_gradient_colors;
+	dst->use_rgba            = src->use_rgba;
+}
+
+void
+murrine_display_list_key_button (MurrineDisplayListKey  *key,
+                                 const WidgetParameters *widget,
+                                 const ButtonParameters *button,
+                                 int width, int height,
+                                 boolean horizontal)
+{
+	murrine_display_list_key_init (key, MRN_DISPLAY_LIST_BUTTON, widget, width, height);
+
+	if (button->has_default_button_color)
+		key->primitive.button.params.default_button_color = button->default_button_color;
+	key->primitive.button.params.has_default_button_color = button->has_default_button_color;
+	key->primitive.button.params.draw_glaze   = button->draw_glaze;
+	key->primitive.button.params.fill_shade   = button->fill_shade;
+	key->primitive.button.params.border_shade = button->border_shade;
+	key->primitive.button.horizontal = horizontal;
+}
+
+void
+murrine_display_list_key_tab (MurrineDisplayListKey  *key,
+                              const WidgetParameters *widget,
+                              const TabParameters    *tab,
+                              int width, int height)
+{
+	murrine_display_list_key_init (key, MRN_DISPLAY_LIST_TAB, widget, width, height);
+
+	key->primitive.tab.gap_side = tab->gap_side;
+}
+
+void
+murrine_display_list_key_progressbar (MurrineDisplayListKey       *key,
+                                      const WidgetParameters      *widget,
+                                      const ProgressBarParameters *progressbar,
+                                      int width, int height)
+{
+	murrine_display_list_key_init (key, MRN_DISPLAY_LIST_PROGRESSBAR, widget, width, height);
+
+	key->primitive.progressbar.orientation = progressbar->orientation;
+	key->primitive.progressbar.style       = progressbar->style;
+}
+
+#ifdef HAVE_RECORDING_SURFACE
+MRN_DEFINE_KEY_HASH (murrine_display_list_key, MurrineDisplayListKey)
+
+static void
+murrine_display_list_replay (cairo_t *cr, cairo_surface_t *list, int x, int y)
+{
+	cairo_save (cr);
+	cairo_set_source_surface (cr, list, x, y);
+	cairo_paint (cr);
+	cairo_restore (cr);
+}
+#endif
+
+MurrineDisplayLists *
+murrine_display_lists_new (void)
+{
+#ifdef HAVE_RECORDING_SURFACE
+	MurrineDisplayLists *lists = g_new0 (MurrineDisplayLists, 1);
+
+	lists->table = g_hash_table_new_full (murrine_display_list_key_hash,
+	                                      murrine_display_list_key_equal,
+	                                      g_free, (GDestroyNotify) cairo_surface_destroy);
+
+	return lists;
+#else
+	return NULL;
+#endif
+}
+
+void
+murrine_display_lists_free (MurrineDisplayLists *lists)
+{
+	if (!lists)
+		return;
+
+	if (lists->recording)
+		cairo_surface_destroy (lists->recording);
+
+	g_hash_table_destroy (lists->table);
+	g_free (lists);
+}
+
+/* Returns the context the primitive has to be drawn on, with x and y
+ * adjusted accordingly, or NULL if a recorded list was replayed on cr.
+ * Unless the returned context is NULL, murrine_display_list_end() must
+ * be called once drawing is done. */
+cairo_t *
+murrine_display_list_begin (MurrineDisplayLists         *lists,
+                            cairo_t                     *cr,
+                            const MurrineDisplayListKey *key,
+                            int *x, int *y)
+{
+#ifdef HAVE_RECORDING_SURFACE
+	cairo_surface_t *list;
+	cairo_t *record;
+
+	/* The rgba functions rely on CAIRO_OPERATOR_SOURCE against the target */
+	if (!lists || lists->recording || key->widget.style != MRN_STYLE_MURRINE)
+		return cr;
+
+	list = g_hash_table_lookup (lists->table, key);
+	if (list)
+	{
+		murrine_display_list_replay (cr, list, *x, *y);
+		return NULL;
+	}
+
+	MRN_TRACE_CACHE_MISS ("display-list", key->width, key->height);
+
+	lists->recording = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, NULL);
+	lists->pending = *key;
+	lists->x = *x;
+	lists->y = *y;
+
+	record = cairo_create (lists->recording);
+	cairo_set_line_width (record, 1.0);
+
+	*x = 0;
+	*y = 0;
+
+	return record;
+#else
+	return cr;
+#endif
+}
+
+void
+murrine_display_list_end (MurrineDisplayLists *lists,
+                          cairo_t             *cr,
+                          cairo_t             *record)
+{
+#ifdef HAVE_RECORDING_SURFACE
+	MurrineDisplayListKey *key;
+
+	if (record == cr)
+		return;
+
+	cairo_destroy (record);
+
+	if (g_hash_table_size (lists->table) >= DISPLAY_LIST_MAX_ENTRIES)
+		g_hash_table_remove_all (lists->table);
+
+	key = g_memdup (&lists->pending, sizeof (MurrineDisplayListKey));
+	g_hash_table_insert (lists->table, key, lists->recording);
+
+	murrine_display_list_replay (cr, lists->recording, lists->x, lists->y);
+	lists->recording = NULL;
+
+	MRN_TRACE_CACHE_FILL ("display-list");
+#endif
+}
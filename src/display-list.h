@@ -0,0 +1,88 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <gtk/gtk.h>
+
+#include "murrine_types.h"
+
+/* Recorded primitives are replayed with a translation when their inputs match,
+ * so only the parameters that affect the output take part in the key. */
+typedef enum
+{
+	MRN_DISPLAY_LIST_BUTTON,
+	MRN_DISPLAY_LIST_TAB,
+	MRN_DISPLAY_LIST_PROGRESSBAR
+} MurrineDisplayListType;
+
+typedef struct
+{
+	MurrineDisplayListType type;
+	int width;
+	int height;
+
+	WidgetParameters widget;
+
+	union
+	{
+		struct
+		{
+			ButtonParameters params;
+			boolean          horizontal;
+		} button;
+		TabParameters tab;
+		ProgressBarParameters progressbar;
+	} primitive;
+} MurrineDisplayListKey;
+
+typedef struct _MurrineDisplayLists MurrineDisplayLists;
+
+G_GNUC_INTERNAL MurrineDisplayLists *murrine_display_lists_new (void);
+
+G_GNUC_INTERNAL void murrine_display_lists_free (MurrineDisplayLists *lists);
+
+G_GNUC_INTERNAL void murrine_display_list_key_button (MurrineDisplayListKey  *key,
+                                                      const WidgetParameters *widget,
+                                                      const ButtonParameters *button,
+                                                      int width, int height,
+                                                      boolean horizontal);
+
+G_GNUC_INTERNAL void murrine_display_list_key_tab (MurrineDisplayListKey  *key,
+                                                   const WidgetParameters *widget,
+                                                   const TabParameters    *tab,
+                                                   int width, int height);
+
+G_GNUC_INTERNAL void murrine_display_list_key_progressbar (MurrineDisplayListKey       *key,
+                                                           const WidgetParameters      *widget,
+                                                           const ProgressBarParameters *progressbar,
+                                                           int width, int height);
+
+G_GNUC_INTERNAL cairo_t *murrine_display_list_begin (MurrineDisplayLists         *lists,
+                                                     cairo_t                     *cr,
+                                                     const MurrineDisplayListKey *key,
+                                                     int *x, int *y);
+
+G_GNUC_INTERNAL void murrine_display_list_end (MurrineDisplayLists *lists,
+                                               cairo_t             *cr,
+                                               cairo_t             *record);
+
+#endif /* DISPLAY_LIST_H */
@@ -0,0 +1,709 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "draw-profile.h"
+#include "profile.h"
+#include "trace.h"
+
+/* Four buckets per power of two, up to about 18 minutes */
+#define HISTOGRAM_SUB_BITS 2
+#define HISTOGRAM_BUCKETS  (40 << HISTOGRAM_SUB_BITS)
+
+typedef struct
+{
+	const gchar *function;
+	gboolean     primitive;
+	const gchar *detail;
+	GType        widget_type;
+} DrawProfileKey;
+
+typedef struct
+{
+	DrawProfileKey key;
+	guint64        calls;
+	guint64        total_ns;
+	guint64        pixels;
+	guint32        histogram[HISTOGRAM_BUCKETS];
+} DrawProfileEntry;
+
+/* The detail and widget of the vfunc being drawn, for the primitives */
+typedef struct _DrawProfileScope DrawProfileScope;
+struct _DrawProfileScope
+{
+	DrawProfileScope *outer;
+	const gchar      *detail;
+	GType             widget_type;
+	gint              draw_style;
+	gint64            start;
+};
+
+static gboolean draw_profile_enabled = FALSE;
+static GHashTable *draw_profile_entries = NULL;
+static DrawProfileScope *draw_profile_scope = NULL;
+static GThread *draw_profile_thread = NULL;
+static guint draw_profile_dump_id = 0;
+
+static gboolean draw_profile_dump (gpointer data);
+
+/* What the wrappers call */
+static GtkStyleClass draw_profile_vfuncs;
+static MurrineStyleFunctions draw_profile_functions[MRN_NUM_DRAW_STYLES];
+
+static guint
+draw_profile_key_hash (gconstpointer v)
+{
+	const DrawProfileKey *key = v;
+
+	return (g_direct_hash (key->function) * 31 + g_direct_hash (key->detail)) * 31 +
+	       (guint) key->widget_type + key->primitive;
+}
+
+static gboolean
+draw_profile_key_equal (gconstpointer a, gconstpointer b)
+{
+	const DrawProfileKey *key_a = a;
+	const DrawProfileKey *key_b = b;
+
+	return key_a->function == key_b->function &&
+	       key_a->primitive == key_b->primitive &&
+	       key_a->detail == key_b->detail &&
+	       key_a->widget_type == key_b->widget_type;
+}
+
+static guint
+histogram_bucket (guint64 ns)
+{
+	guint octave, bucket;
+
+	if (ns < (1 << HISTOGRAM_SUB_BITS))
+		return ns;
+
+	octave = g_bit_storage (ns) - 1;
+	bucket = ((octave - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS) +
+	         ((ns >> (octave - HISTOGRAM_SUB_BITS)) & ((1 << HISTOGRAM_SUB_BITS) - 1));
+
+	return MIN (bucket, HISTOGRAM_BUCKETS - 1);
+}
+
+/* The middle of the range of a bucket */
+static guint64
+histogram_value (guint bucket)
+{
+	guint octave, sub;
+
+	if (bucket < (1 << HISTOGRAM_SUB_BITS))
+		return bucket;
+
+	octave = (bucket >> HISTOGRAM_SUB_BITS) + HISTOGRAM_SUB_BITS - 1;
+	sub = bucket & ((1 << HISTOGRAM_SUB_BITS) - 1);
+
+	return ((guint64) ((1 << HISTOGRAM_SUB_BITS) + sub) << (octave - HISTOGRAM_SUB_BITS)) +
+	       (G_GUINT64_CONSTANT (1) << (octave - HISTOGRAM_SUB_BITS)) / 2;
+}
+
+static guint64
+histogram_percentile (const DrawProfileEntry *entry, guint percent)
+{
+	guint64 rank = (entry->calls * percent + 99) / 100;
+	guint64 count = 0;
+	guint i;
+
+	for (i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		count += entry->histogram[i];
+		if (count >= rank && count > 0)
+			return histogram_value (i);
+	}
+
+	return 0;
+}
+
+static void
+draw_profile_record (const gchar *function, gboolean primitive,
+                     const gchar *detail, GType widget_type,
+                     gint64 elapsed, guint64 pixels)
+{
+	DrawProfileEntry *entry;
+	DrawProfileKey key;
+
+	memset (&key, 0, sizeof (key));
+	key.function = function;
+	key.primitive = primitive;
+	key.detail = detail;
+	key.widget_type = widget_type;
+
+	if (draw_profile_entries == NULL)
+		draw_profile_entries = g_hash_table_new_full (draw_profile_key_hash, draw_profile_key_equal,
+		                                              NULL, g_free);
+
+	entry = g_hash_table_lookup (draw_profile_entries, &key);
+	if (entry == NULL)
+	{
+		entry = g_new0 (DrawProfileEntry, 1);
+		entry->key = key;
+		g_hash_table_insert (draw_profile_entries, &entry->key, entry);
+	}
+
+	if (elapsed < 0)
+		elapsed = 0;
+
+	entry->calls++;
+	entry->total_ns += elapsed;
+	entry->pixels += pixels;
+	entry->histogram[histogram_bucket (elapsed)]++;
+}
+
+static guint64
+draw_profile_area (GdkWindow *window, gint width, gint height)
+{
+	if (!draw_profile_enabled)
+		return 0;
+
+	if (width < 0 || height < 0)
+		gdk_drawable_get_size (window, width < 0 ? &width : NULL, height < 0 ? &height : NULL);
+
+	return (guint64) MAX (width, 0) * MAX (height, 0);
+}
+
+static void
+draw_profile_enter (DrawProfileScope *scope, const gchar *function,
+                    GtkWidget *widget, const gchar *detail, gint width, gint height)
+{
+	if (MRN_TRACE_VFUNC_BEGIN_ENABLED ())
+		MRN_TRACE_VFUNC_BEGIN (function, widget ? G_OBJECT_TYPE_NAME (widget) : NULL,
+		                       detail, width, height);
+
+	scope->outer = draw_profile_scope;
+	scope->detail = detail && draw_profile_enabled ? g_intern_string (detail) : NULL;
+	scope->widget_type = widget ? G_OBJECT_TYPE (widget) : 0;
+	scope->draw_style = -1;
+	draw_profile_scope = scope;
+
+	scope->start = draw_profile_enabled ? murrine_profile_now () : 0;
+}
+
+static void
+draw_profile_leave (DrawProfileScope *scope, const gchar *function, guint64 pixels)
+{
+	MRN_TRACE_VFUNC_END (function, scope->draw_style);
+
+	draw_profile_scope = scope->outer;
+
+	if (draw_profile_enabled)
+		draw_profile_record (function, FALSE, scope->detail, scope->widget_type,
+		                     murrine_profile_now () - scope->start, pixels);
+}
+
+/* The frame cache draws from its worker threads, which are left out */
+static gint64
+draw_profile_primitive_begin (const gchar *function, const WidgetParameters *widget,
+                              int width, int height)
+{
+	MRN_TRACE_PRIMITIVE_BEGIN (function, widget->style, width, height);
+
+	if (g_thread_self () != draw_profile_thread)
+		return 0;
+
+	if (draw_profile_scope)
+		draw_profile_scope->draw_style = widget->style;
+
+	return draw_profile_enabled ? murrine_profile_now () : 0;
+}
+
+static void
+draw_profile_primitive_end (const gchar *function, gint64 start, int width, int height)
+{
+	const DrawProfileScope *scope = draw_profile_scope;
+
+	MRN_TRACE_PRIMITIVE_END (function);
+
+	if (start == 0)
+		return;
+
+	draw_profile_record (function, TRUE,
+	                     scope ? scope->detail : NULL, scope ? scope->widget_type : 0,
+	                     murrine_profile_now () - start,
+	                     (guint64) MAX (width, 0) * MAX (height, 0));
+}
+
+/* GtkStyle vfuncs */
+
+#define DRAW_ARGS GtkStyle      *style, \
+                  GdkWindow     *window, \
+                  GtkStateType  state_type, \
+                  GtkShadowType shadow_type, \
+                  GdkRectangle  *area, \
+                  GtkWidget     *widget, \
+                  const gchar   *detail, \
+                  gint          x, \
+                  gint          y, \
+                  gint          width, \
+                  gint          height
+
+#define VFUNC(name) \
+static void \
+profile_style_##name (DRAW_ARGS) \
+{ \
+	DrawProfileScope scope; \
+	draw_profile_enter (&scope, #name, widget, detail, width, height); \
+	draw_profile_vfuncs.name (style, window, state_type, shadow_type, area, widget, detail, \
+	                          x, y, width, height); \
+	draw_profile_leave (&scope, #name, draw_profile_area (window, width, height)); \
+}
+
+#define VFUNC_GAP(name) \
+static void \
+profile_style_##name (DRAW_ARGS, GtkPositionType gap_side, gint gap_x, gint gap_width) \
+{ \
+	DrawProfileScope scope; \
+	draw_profile_enter (&scope, #name, widget, detail, width, height); \
+	draw_profile_vfuncs.name (style, window, state_type, shadow_type, area, widget, detail, \
+	                          x, y, width, height, gap_side, gap_x, gap_width); \
+	draw_profile_leave (&scope, #name, draw_profile_area (window, width, height)); \
+}
+
+#define VFUNC_EXTRA(name, type) \
+static void \
+profile_style_##name (DRAW_ARGS, type extra) \
+{ \
+	DrawProfileScope scope; \
+	draw_profile_enter (&scope, #name, widget, detail, width, height); \
+	draw_profile_vfuncs.name (style, window, state_type, shadow_type, area, widget, detail, \
+	                          x, y, width, height, extra); \
+	draw_profile_leave (&scope, #name, draw_profile_area (window, width, height)); \
+}
+
+VFUNC (draw_box)
+VFUNC (draw_check)
+VFUNC (draw_flat_box)
+VFUNC (draw_option)
+VFUNC (draw_shadow)
+VFUNC (draw_tab)
+VFUNC_GAP (draw_box_gap)
+VFUNC_GAP (draw_shadow_gap)
+VFUNC_EXTRA (draw_extension, GtkPositionType)
+VFUNC_EXTRA (draw_handle, GtkOrientation)
+VFUNC_EXTRA (draw_slider, GtkOrientation)
+
+static void
+profile_style_draw_arrow (GtkStyle *style, GdkWindow *window, GtkStateType state_type,
+                          GtkShadowType shadow, GdkRectangle *area, GtkWidget *widget,
+                          const gchar *detail, GtkArrowType arrow_type, gboolean fill,
+                          gint x, gint y, gint width, gint height)
+{
+	DrawProfileScope scope;
+
+	draw_profile_enter (&scope, "draw_arrow", widget, detail, width, height);
+	draw_profile_vfuncs.draw_arrow (style, window, state_type, shadow, area, widget, detail,
+	                                arrow_type, fill, x, y, width, height);
+	draw_profile_leave (&scope, "draw_arrow", draw_profile_area (window, width, height));
+}
+
+static void
+profile_style_draw_expander (GtkStyle *style, GdkWindow *window, GtkStateType state_type,
+                             GdkRectangle *area, GtkWidget *widget, const gchar *detail,
+                             gint x, gint y, GtkExpanderStyle expander_style)
+{
+	DrawProfileScope scope;
+
+	draw_profile_enter (&scope, "draw_expander", widget, detail, -1, -1);
+	draw_profile_vfuncs.draw_expander (style, window, state_type, area, widget, detail,
+	                                   x, y, expander_style);
+	draw_profile_leave (&scope, "draw_expander", 0);
+}
+
+static void
+profile_style_draw_focus (GtkStyle *style, GdkWindow *window, GtkStateType state_type,
+                          GdkRectangle *area, GtkWidget *widget, const gchar *detail,
+                          gint x, gint y, gint width, gint height)
+{
+	DrawProfileScope scope;
+
+	draw_profile_enter (&scope, "draw_focus", widget, detail, width, height);
+	draw_profile_vfuncs.draw_focus (style, window, state_type, area, widget, detail,
+	                                x, y, width, height);
+	draw_profile_leave (&scope, "draw_focus", draw_profile_area (window, width, height));
+}
+
+static void
+profile_style_draw_hline (GtkStyle *style, GdkWindow *window, GtkStateType state_type,
+                          GdkRectangle *area, GtkWidget *widget, const gchar *detail,
+                          gint x1, gint x2, gint y)
+{
+	DrawProfileScope scope;
+
+	draw_profile_enter (&scope, "draw_hline", widget, detail, ABS (x2 - x1) + 1, 1);
+	draw_profile_vfuncs.draw_hline (style, window, state_type, area, widget, detail, x1, x2, y);
+	draw_profile_leave (&scope, "draw_hline", ABS (x2 - x1) + 1);
+}
+
+static void
+profile_style_draw_vline (GtkStyle *style, GdkWindow *window, GtkStateType state_type,
+                          GdkRectangle *area, GtkWidget *widget, const gchar *detail,
+                          gint y1, gint y2, gint x)
+{
+	DrawProfileScope scope;
+
+	draw_profile_enter (&scope, "draw_vline", widget, detail, 1, ABS (y2 - y1) + 1);
+	draw_profile_vfuncs.draw_vline (style, window, state_type, area, widget, detail, y1, y2, x);
+	draw_profile_leave (&scope, "draw_vline", ABS (y2 - y1) + 1);
+}
+
+static void
+profile_style_draw_layout (GtkStyle *style, GdkWindow *window, GtkStateType state_type,
+                           gboolean use_text, GdkRectangle *area, GtkWidget *widget,
+                           const gchar *detail, gint x, gint y, PangoLayout *layout)
+{
+	DrawProfileScope scope;
+	gint width, height;
+
+	draw_profile_enter (&scope, "draw_layout", widget, detail, -1, -1);
+	draw_profile_vfuncs.draw_layout (style, window, state_type, use_text, area, widget, detail,
+	                                 x, y, layout);
+	width = height = 0;
+	if (draw_profile_enabled)
+		pango_layout_get_pixel_size (layout, &width, &height);
+	draw_profile_leave (&scope, "draw_layout", (guint64) width * height);
+}
+
+static void
+profile_style_draw_resize_grip (GtkStyle *style, GdkWindow *window, GtkStateType state_type,
+                                GdkRectangle *area, GtkWidget *widget, const gchar *detail,
+                                GdkWindowEdge edge, gint x, gint y, gint width, gint height)
+{
+	DrawProfileScope scope;
+
+	draw_profile_enter (&scope, "draw_resize_grip", widget, detail, width, height);
+	draw_profile_vfuncs.draw_resize_grip (style, window, state_type, area, widget, detail,
+	                                      edge, x, y, width, height);
+	draw_profile_leave (&scope, "draw_resize_grip", draw_profile_area (window, width, height));
+}
+
+static GdkPixbuf *
+profile_style_render_icon (GtkStyle *style, const GtkIconSource *source, GtkTextDirection direction,
+                           GtkStateType state, GtkIconSize size, GtkWidget *widget, const char *detail)
+{
+	DrawProfileScope scope;
+	GdkPixbuf *pixbuf;
+
+	draw_profile_enter (&scope, "render_icon", widget, detail, -1, -1);
+	pixbuf = draw_profile_vfuncs.render_icon (style, source, direction, state, size, widget, detail);
+	draw_profile_leave (&scope, "render_icon",
+	                    pixbuf ? (guint64) gdk_pixbuf_get_width (pixbuf) * gdk_pixbuf_get_height (pixbuf) : 0);
+
+	return pixbuf;
+}
+
+/* MurrineStyleFunctions, the original is picked by the style in the
+ * widget parameters */
+
+#define PRIMITIVE(name, type) \
+static void \
+profile_primitive_##name (cairo_t *cr, const MurrineColors *colors, const WidgetParameters *widget, \
+                          const type *params, int x, int y, int width, int height) \
+{ \
+	gint64 start = draw_profile_primitive_begin (#name, widget, width, height); \
+	draw_profile_functions[widget->style].name (cr, colors, widget, params, x, y, width, height); \
+	draw_profile_primitive_end (#name, start, width, height); \
+}
+
+#define PRIMITIVE_EXTRA(name, type, extra_type) \
+static void \
+profile_primitive_##name (cairo_t *cr, const MurrineColors *colors, const WidgetParameters *widget, \
+                          const type *params, int x, int y, int width, int height, extra_type extra) \
+{ \
+	gint64 start = draw_profile_primitive_begin (#name, widget, width, height); \
+	draw_profile_functions[widget->style].name (cr, colors, widget, params, x, y, width, height, extra); \
+	draw_profile_primitive_end (#name, start, width, height); \
+}
+
+#define PRIMITIVE_NO_PARAMS(name) \
+static void \
+profile_primitive_##name (cairo_t *cr, const MurrineColors *colors, const WidgetParameters *widget, \
+                          int x, int y, int width, int height) \
+{ \
+	gint64 start = draw_profile_primitive_begin (#name, widget, width, height); \
+	draw_profile_functions[widget->style].name (cr, colors, widget, x, y, width, height); \
+	draw_profile_primitive_end (#name, start, width, height); \
+}
+
+#define PRIMITIVE_STYLE(name) \
+static void \
+profile_primitive_##name (cairo_t *cr, const MurrineColors *colors, const WidgetParameters *widget, \
+                          int x, int y, int width, int height, int style) \
+{ \
+	gint64 start = draw_profile_primitive_begin (#name, widget, width, height); \
+	draw_profile_functions[widget->style].name (cr, colors, widget, x, y, width, height, style); \
+	draw_profile_primitive_end (#name, start, width, height); \
+}
+
+PRIMITIVE_EXTRA (draw_button, ButtonParameters, boolean)
+
+static void
+profile_primitive_draw_combobox (cairo_t *cr, MurrineColors colors, WidgetParameters widget,
+                                 const ComboBoxParameters *combobox,
+                                 int x, int y, int width, int height, boolean vertical)
+{
+	gint64 start = draw_profile_primitive_begin ("draw_combobox", &widget, width, height);
+
+	draw_profile_functions[widget.style].draw_combobox (cr, colors, widget, combobox,
+	                                                    x, y, width, height, vertical);
+	draw_profile_primitive_end ("draw_combobox", start, width, height);
+}
+
+PRIMITIVE (draw_scale_trough, SliderParameters)
+PRIMITIVE (draw_slider, SliderParameters)
+PRIMITIVE_EXTRA (draw_slider_handle, HandleParameters, boolean)
+PRIMITIVE (draw_progressbar_trough, ProgressBarParameters)
+PRIMITIVE_EXTRA (draw_progressbar_fill, ProgressBarParameters, gint)
+PRIMITIVE (draw_entry, FocusParameters)
+PRIMITIVE (draw_spinbutton_entry, FocusParameters)
+PRIMITIVE (draw_search_entry, FocusParameters)
+PRIMITIVE (draw_entry_progress, EntryProgressParameters)
+
+static void
+profile_primitive_draw_expander (cairo_t *cr, const MurrineColors *colors,
+                                 const MurrineRGB treeview_expander_color,
+                                 const WidgetParameters *widget,
+                                 const ExpanderParameters *expander, int x, int y)
+{
+	gint64 start = draw_profile_primitive_begin ("draw_expander", widget,
+	                                             expander->size, expander->size);
+
+	draw_profile_functions[widget->style].draw_expander (cr, colors, treeview_expander_color,
+	                                                     widget, expander, x, y);
+	draw_profile_primitive_end ("draw_expander", start, expander->size, expander->size);
+}
+
+PRIMITIVE_EXTRA (draw_spinbutton, SpinbuttonParameters, boolean)
+PRIMITIVE_NO_PARAMS (draw_spinbutton_down)
+PRIMITIVE (draw_optionmenu, OptionMenuParameters)
+PRIMITIVE_STYLE (draw_menubar)
+PRIMITIVE (draw_tab, TabParameters)
+PRIMITIVE (draw_frame, FrameParameters)
+PRIMITIVE (draw_separator, SeparatorParameters)
+PRIMITIVE_NO_PARAMS (draw_combo_separator)
+PRIMITIVE (draw_list_view_header, ListViewHeaderParameters)
+PRIMITIVE (draw_toolbar, ToolbarParameters)
+PRIMITIVE_STYLE (draw_menuitem)
+PRIMITIVE (draw_scrollbar_stepper, ScrollBarParameters)
+PRIMITIVE (draw_scrollbar_slider, ScrollBarParameters)
+PRIMITIVE (draw_scrollbar_trough, ScrollBarParameters)
+PRIMITIVE (draw_selected_cell, CellParameters)
+PRIMITIVE_NO_PARAMS (draw_statusbar)
+PRIMITIVE_STYLE (draw_menu_frame)
+PRIMITIVE_NO_PARAMS (draw_tooltip)
+PRIMITIVE_NO_PARAMS (draw_iconview)
+PRIMITIVE (draw_handle, HandleParameters)
+PRIMITIVE (draw_arrow, ArrowParameters)
+PRIMITIVE_EXTRA (draw_checkbox, CheckboxParameters, double)
+PRIMITIVE_EXTRA (draw_radiobutton, CheckboxParameters, double)
+PRIMITIVE (draw_resize_grip, ResizeGripParameters)
+PRIMITIVE (draw_focus, FocusParameters)
+
+void
+murrine_draw_profile_install (GtkStyleClass         *style_class,
+                              MurrineStyleFunctions *functions)
+{
+	const gchar *env = g_getenv ("XAMARIN_DRAW_PROFILE");
+	guint period;
+	guint i;
+
+	draw_profile_enabled = env && *env && strcmp (env, "0") != 0;
+
+	/* the wrappers carry the vfunc and primitive probes, they are only
+	 * worth their cost while profiling or tracing */
+	if (!draw_profile_enabled &&
+	    !MRN_TRACE_VFUNC_BEGIN_ENABLED () && !MRN_TRACE_VFUNC_END_ENABLED () &&
+	    !MRN_TRACE_PRIMITIVE_BEGIN_ENABLED () && !MRN_TRACE_PRIMITIVE_END_ENABLED ())
+		return;
+
+	draw_profile_thread = g_thread_self ();
+
+	draw_profile_vfuncs = *style_class;
+	memcpy (draw_profile_functions, functions, sizeof (draw_profile_functions));
+
+	style_class->draw_arrow       = profile_style_draw_arrow;
+	style_class->draw_layout      = profile_style_draw_layout;
+	style_class->draw_box         = profile_style_draw_box;
+	style_class->draw_box_gap     = profile_style_draw_box_gap;
+	style_class->draw_check       = profile_style_draw_check;
+	style_class->draw_expander    = profile_style_draw_expander;
+	style_class->draw_extension   = profile_style_draw_extension;
+	style_class->draw_flat_box    = profile_style_draw_flat_box;
+	style_class->draw_focus       = profile_style_draw_focus;
+	style_class->draw_handle      = profile_style_draw_handle;
+	style_class->draw_hline       = profile_style_draw_hline;
+	style_class->draw_option      = profile_style_draw_option;
+	style_class->render_icon      = profile_style_render_icon;
+	style_class->draw_resize_grip = profile_style_draw_resize_grip;
+	style_class->draw_shadow      = profile_style_draw_shadow;
+	style_class->draw_shadow_gap  = profile_style_draw_shadow_gap;
+	style_class->draw_slider      = profile_style_draw_slider;
+	style_class->draw_tab         = profile_style_draw_tab;
+	style_class->draw_vline       = profile_style_draw_vline;
+
+	for (i = 0; i < MRN_NUM_DRAW_STYLES; i++)
+	{
+		functions[i].draw_button = profile_primitive_draw_button;
+		functions[i].draw_combobox = profile_primitive_draw_combobox;
+		functions[i].draw_scale_trough = profile_primitive_draw_scale_trough;
+		functions[i].draw_slider = profile_primitive_draw_slider;
+		functions[i].draw_slider_handle = profile_primitive_draw_slider_handle;
+		functions[i].draw_progressbar_trough = profile_primitive_draw_progressbar_trough;
+		functions[i].draw_progressbar_fill = profile_primitive_draw_progressbar_fill;
+		functions[i].draw_entry = profile_primitive_draw_entry;
+		functions[i].draw_spinbutton_entry = profile_primitive_draw_spinbutton_entry;
+		functions[i].draw_search_entry = profile_primitive_draw_search_entry;
+		functions[i].draw_entry_progress = profile_primitive_draw_entry_progress;
+		functions[i].draw_expander = profile_primitive_draw_expander;
+		functions[i].draw_spinbutton = profile_primitive_draw_spinbutton;
+		functions[i].draw_spinbutton_down = profile_primitive_draw_spinbutton_down;
+		functions[i].draw_optionmenu = profile_primitive_draw_optionmenu;
+		functions[i].draw_menubar = profile_primitive_draw_menubar;
+		functions[i].draw_tab = profile_primitive_draw_tab;
+		functions[i].draw_frame = profile_primitive_draw_frame;
+		functions[i].draw_separator = profile_primitive_draw_separator;
+		functions[i].draw_combo_separator = profile_primitive_draw_combo_separator;
+		functions[i].draw_list_view_header = profile_primitive_draw_list_view_header;
+		functions[i].draw_toolbar = profile_primitive_draw_toolbar;
+		functions[i].draw_menuitem = profile_primitive_draw_menuitem;
+		functions[i].draw_scrollbar_stepper = profile_primitive_draw_scrollbar_stepper;
+		functions[i].draw_scrollbar_slider = profile_primitive_draw_scrollbar_slider;
+		functions[i].draw_scrollbar_trough = profile_primitive_draw_scrollbar_trough;
+		functions[i].draw_selected_cell = profile_primitive_draw_selected_cell;
+		functions[i].draw_statusbar = profile_primitive_draw_statusbar;
+		functions[i].draw_menu_frame = profile_primitive_draw_menu_frame;
+		functions[i].draw_tooltip = profile_primitive_draw_tooltip;
+		functions[i].draw_iconview = profile_primitive_draw_iconview;
+		functions[i].draw_handle = profile_primitive_draw_handle;
+		functions[i].draw_arrow = profile_primitive_draw_arrow;
+		functions[i].draw_checkbox = profile_primitive_draw_checkbox;
+		functions[i].draw_radiobutton = profile_primitive_draw_radiobutton;
+		functions[i].draw_resize_grip = profile_primitive_draw_resize_grip;
+		functions[i].draw_focus = profile_primitive_draw_focus;
+	}
+
+	period = draw_profile_enabled ? strtoul (env, NULL, 10) : 0;
+	if (period > 0)
+		draw_profile_dump_id = g_timeout_add_seconds (period, draw_profile_dump, NULL);
+}
+
+static gint
+draw_profile_compare (gconstpointer a, gconstpointer b)
+{
+	const DrawProfileEntry *entry_a = *(DrawProfileEntry * const *) a;
+	const DrawProfileEntry *entry_b = *(DrawProfileEntry * const *) b;
+
+	if (entry_a->total_ns != entry_b->total_ns)
+		return entry_a->total_ns > entry_b->total_ns ? -1 : 1;
+
+	return 0;
+}
+
+/* Calls func for every function, detail and widget type drawn, the most
+ * expensive first */
+void
+murrine_draw_profile_foreach (MurrineDrawStatsFunc func, gpointer user_data)
+{
+	GHashTableIter iter;
+	GPtrArray *entries;
+	gpointer entry;
+	guint i;
+
+	if (draw_profile_entries == NULL)
+		return;
+
+	entries = g_ptr_array_sized_new (g_hash_table_size (draw_profile_entries));
+
+	g_hash_table_iter_init (&iter, draw_profile_entries);
+	while (g_hash_table_iter_next (&iter, NULL, &entry))
+		g_ptr_array_add (entries, entry);
+
+	g_ptr_array_sort (entries, draw_profile_compare);
+
+	for (i = 0; i < entries->len; i++)
+	{
+		const DrawProfileEntry *e = g_ptr_array_index (entries, i);
+		MurrineDrawStats stats;
+
+		stats.function = e->key.function;
+		stats.primitive = e->key.primitive;
+		stats.detail = e->key.detail;
+		stats.widget_type = e->key.widget_type ? g_type_name (e->key.widget_type) : NULL;
+		stats.calls = e->calls;
+		stats.total_ns = e->total_ns;
+		stats.p50_ns = histogram_percentile (e, 50);
+		stats.p90_ns = histogram_percentile (e, 90);
+		stats.p99_ns = histogram_percentile (e, 99);
+		stats.pixels = e->pixels;
+
+		func (&stats, user_data);
+	}
+
+	g_ptr_array_free (entries, TRUE);
+}
+
+void
+murrine_draw_profile_reset (void)
+{
+	if (draw_profile_entries)
+		g_hash_table_remove_all (draw_profile_entries);
+}
+
+static void
+draw_profile_print (const MurrineDrawStats *stats, gpointer user_data)
+{
+	g_printerr ("xamarin-draw: %-9s %-24s %-20s %-24s %8" G_GUINT64_FORMAT " calls"
+	            " %12" G_GUINT64_FORMAT " ns p50 %" G_GUINT64_FORMAT " p90 %" G_GUINT64_FORMAT
+	            " p99 %" G_GUINT64_FORMAT " ns %12" G_GUINT64_FORMAT " px\n",
+	            stats->primitive ? "primitive" : "vfunc", stats->function,
+	            stats->detail ? stats->detail : "-",
+	            stats->widget_type ? stats->widget_type : "-",
+	            stats->calls, stats->total_ns,
+	            stats->p50_ns, stats->p90_ns, stats->p99_ns, stats->pixels);
+}
+
+static gboolean
+draw_profile_dump (gpointer data)
+{
+	murrine_draw_profile_foreach (draw_profile_print, NULL);
+
+	return TRUE;
+}
+
+void
+murrine_draw_profile_shutdown (void)
+{
+	if (draw_profile_dump_id)
+	{
+		g_source_remove (draw_profile_dump_id);
+		draw_profile_dump_id = 0;
+	}
+
+	if (draw_profile_entries)
+	{
+		g_hash_table_destroy (draw_profile_entries);
+		draw_profile_entries = NULL;
+	}
+}
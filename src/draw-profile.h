@@ -0,0 +1,62 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef DRAW_PROFILE_H
+#define DRAW_PROFILE_H
+
+#include <gtk/gtk.h>
+
+#include "murrine_types.h"
+
+/* Timings of the GtkStyle vfuncs and of the MurrineStyleFunctions, per
+ * detail and widget type. A primitive is accounted to the detail and
+ * widget of the vfunc drawing it. Percentiles are estimated from a
+ * histogram with four buckets per power of two. */
+typedef struct
+{
+	const gchar *function;
+	gboolean     primitive;   /* a member of MurrineStyleFunctions */
+	const gchar *detail;      /* NULL if there is none */
+	const gchar *widget_type; /* NULL without a widget */
+	guint64      calls;
+	guint64      total_ns;
+	guint64      p50_ns;
+	guint64      p90_ns;
+	guint64      p99_ns;
+	guint64      pixels;
+} MurrineDrawStats;
+
+typedef void (*MurrineDrawStatsFunc) (const MurrineDrawStats *stats, gpointer user_data);
+
+/* Wraps the vfuncs and the style functions when XAMARIN_DRAW_PROFILE is
+ * set, or when a tracer is attached to the vfunc or primitive probes as
+ * the style class is initialized; otherwise the vtables are left alone.
+ * The value is the period in seconds the statistics are printed on
+ * stderr with. Only drawing from the thread running gtk is accounted. */
+G_GNUC_INTERNAL void murrine_draw_profile_install (GtkStyleClass         *style_class,
+                                                   MurrineStyleFunctions *functions);
+
+G_GNUC_INTERNAL void murrine_draw_profile_foreach (MurrineDrawStatsFunc func, gpointer user_data);
+
+G_GNUC_INTERNAL void murrine_draw_profile_reset (void);
+
+G_GNUC_INTERNAL void murrine_draw_profile_shutdown (void);
+
+#endif /* DRAW_PROFILE_H */
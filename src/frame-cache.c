@@ -0,0 +1,270 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <string.h>
+
+#include "frame-cache.h"
+#include "display-list.h"
+#include "raster-cache.h"
+#include "support.h"
+#include "trace.h"
+
+/* Frame sets kept per style before the cache starts over */
+#define FRAME_CACHE_MAX_ENTRIES 16
+
+typedef struct
+{
+	MurrineDisplayListKey primitive;
+	double                scale;
+	int                   first_offset;
+} FrameKey;
+
+typedef struct
+{
+	gboolean         queued;
+	gboolean         ready;
+	cairo_surface_t *frames[MRN_FRAME_CACHE_FRAMES];
+} FrameSet;
+
+struct _MurrineFrameCache
+{
+	gint        ref_count;
+	GHashTable *sets;
+};
+
+/* Everything a worker needs to render a set on its own */
+typedef struct
+{
+	MurrineFrameCache    *cache;
+	FrameKey              key;
+	MurrineColors         colors;
+	WidgetParameters      widget;
+	ProgressBarParameters progressbar;
+} FrameJob;
+
+/* Guards the sets of all caches, which workers fill in */
+G_LOCK_DEFINE_STATIC (frame_cache);
+
+static GThreadPool *frame_pool = NULL;
+static gint         frame_cache_enabled = -1;
+
+MRN_DEFINE_KEY_HASH (frame_key, FrameKey)
+
+static void
+frame_set_free (FrameSet *set)
+{
+	int i;
+
+	if (set->ready)
+		for (i = 0; i < MRN_FRAME_CACHE_FRAMES; i++)
+			cairo_surface_destroy (set->frames[i]);
+
+	g_free (set);
+}
+
+/* Runs on the worker thread. Drawing only touches the job and the
+ * locked raster cache, so no gdk or widget access happens here. */
+static void
+frame_job_run (gpointer data, gpointer user_data)
+{
+	FrameJob *job = data;
+	cairo_surface_t *frames[MRN_FRAME_CACHE_FRAMES];
+	FrameSet *set;
+	int width  = job->key.primitive.width;
+	int height = job->key.primitive.height;
+	int i;
+
+	MRN_TRACE_CACHE_MISS ("frame", width, height);
+
+	for (i = 0; i < MRN_FRAME_CACHE_FRAMES; i++)
+	{
+		cairo_t *cr;
+
+		frames[i] = murrine_raster_surface_create (width, height, job->key.scale);
+		cr = cairo_create (frames[i]);
+		cairo_set_line_width (cr, 1.0);
+		job->widget.style_functions->draw_progressbar_fill (cr, &job->colors, &job->widget, &job->progressbar,
+		                                                     0, 0, width, height,
+		                                                     job->key.first_offset + i);
+		cairo_destroy (cr);
+	}
+
+	G_LOCK (frame_cache);
+
+	/* the set may have been dropped meanwhile */
+	set = g_hash_table_lookup (job->cache->sets, &job->key);
+	if (set && !set->ready)
+	{
+		memcpy (set->frames, frames, sizeof (frames));
+		set->ready = TRUE;
+	}
+	else
+	{
+		for (i = 0; i < MRN_FRAME_CACHE_FRAMES; i++)
+			cairo_surface_destroy (frames[i]);
+	}
+
+	G_UNLOCK (frame_cache);
+
+	MRN_TRACE_CACHE_FILL ("frame");
+
+	murrine_frame_cache_unref (job->cache);
+	g_free (job);
+}
+
+/* Returns NULL unless XAMARIN_PRERENDER_FRAMES is set and a worker
+ * thread can be started. */
+MurrineFrameCache *
+murrine_frame_cache_new (void)
+{
+	MurrineFrameCache *cache;
+
+	if (frame_cache_enabled < 0)
+	{
+		const gchar *env = g_getenv ("XAMARIN_PRERENDER_FRAMES");
+
+		frame_cache_enabled = env && *env && strcmp (env, "0") != 0 && g_thread_supported ();
+	}
+
+	if (!frame_cache_enabled)
+		return NULL;
+
+	if (!frame_pool)
+	{
+		frame_pool = g_thread_pool_new (frame_job_run, NULL, 1, FALSE, NULL);
+		if (!frame_pool)
+		{
+			frame_cache_enabled = FALSE;
+			return NULL;
+		}
+	}
+
+	cache = g_new0 (MurrineFrameCache, 1);
+	cache->ref_count = 1;
+	cache->sets = g_hash_table_new_full (frame_key_hash, frame_key_equal,
+	                                     g_free, (GDestroyNotify) frame_set_free);
+
+	return cache;
+}
+
+/* Pending jobs hold a reference, so the cache outlives its style until
+ * the worker is done with it */
+void
+murrine_frame_cache_unref (MurrineFrameCache *cache)
+{
+	if (!cache || !g_atomic_int_dec_and_test (&cache->ref_count))
+		return;
+
+	G_LOCK (frame_cache);
+	g_hash_table_destroy (cache->sets);
+	G_UNLOCK (frame_cache);
+
+	g_free (cache);
+}
+
+/* Paints the frame of a horizontal progress bar fill for the given offset,
+ * which has to lie in the MRN_FRAME_CACHE_FRAMES offsets starting at
+ * first_offset. Returns FALSE if the frame is not rendered yet, it has to
+ * be drawn directly then. A set is rendered once a size has been asked for
+ * twice, bars that keep growing are not worth it. */
+gboolean
+murrine_frame_cache_draw_progressbar (MurrineFrameCache           *cache,
+                                      cairo_t                     *cr,
+                                      const MurrineColors         *colors,
+                                      const WidgetParameters      *widget,
+                                      const ProgressBarParameters *progressbar,
+                                      int x, int y, int width, int height,
+                                      int first_offset, int offset)
+{
+	cairo_surface_t *frame = NULL;
+	FrameSet *set;
+	FrameKey key;
+	int index = offset - first_offset;
+
+	/* vertical fills are drawn outside of their box, rgba ones rely on
+	 * the operators against the target */
+	if (!cache || !frame_pool ||
+	    widget->style != MRN_STYLE_MURRINE ||
+	    progressbar->orientation >= 2 ||
+	    index < 0 || index >= MRN_FRAME_CACHE_FRAMES ||
+	    width <= 0 || height <= 0)
+		return FALSE;
+
+	memset (&key, 0, sizeof (FrameKey));
+	murrine_display_list_key_progressbar (&key.primitive, widget, progressbar, width, height);
+	key.scale = murrine_get_device_scale (cr);
+	key.first_offset = first_offset;
+
+	G_LOCK (frame_cache);
+
+	set = g_hash_table_lookup (cache->sets, &key);
+	if (!set)
+	{
+		if (g_hash_table_size (cache->sets) >= FRAME_CACHE_MAX_ENTRIES)
+			g_hash_table_remove_all (cache->sets);
+
+		set = g_new0 (FrameSet, 1);
+		g_hash_table_insert (cache->sets, g_memdup (&key, sizeof (FrameKey)), set);
+	}
+	else if (set->ready)
+	{
+		frame = cairo_surface_reference (set->frames[index]);
+	}
+	else if (!set->queued)
+	{
+		FrameJob *job = g_new (FrameJob, 1);
+
+		g_atomic_int_inc (&cache->ref_count);
+		job->cache       = cache;
+		job->key         = key;
+		job->colors      = *colors;
+		job->widget      = *widget;
+		job->progressbar = *progressbar;
+
+		set->queued = TRUE;
+		g_thread_pool_push (frame_pool, job, NULL);
+	}
+
+	G_UNLOCK (frame_cache);
+
+	if (!frame)
+		return FALSE;
+
+	cairo_save (cr);
+	cairo_set_source_surface (cr, frame, x, y);
+	cairo_paint (cr);
+	cairo_restore (cr);
+	cairo_surface_destroy (frame);
+
+	return TRUE;
+}
+
+/* Waits for the worker to finish the queued sets and stops it */
+void
+murrine_frame_cache_shutdown (void)
+{
+	if (frame_pool)
+	{
+		g_thread_pool_free (frame_pool, FALSE, TRUE);
+		frame_pool = NULL;
+	}
+
+	frame_cache_enabled = -1;
+}
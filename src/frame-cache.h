@@ -0,0 +1,48 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <gtk/gtk.h>
+
+#include "murrine_types.h"
+
+/* Periodic animations cycle through a fixed number of frames, which a
+ * worker thread renders ahead so that drawing one is a blit. */
+#define MRN_FRAME_CACHE_FRAMES 10
+
+typedef struct _MurrineFrameCache MurrineFrameCache;
+
+G_GNUC_INTERNAL MurrineFrameCache *murrine_frame_cache_new (void);
+
+G_GNUC_INTERNAL void murrine_frame_cache_unref (MurrineFrameCache *cache);
+
+G_GNUC_INTERNAL gboolean murrine_frame_cache_draw_progressbar (MurrineFrameCache           *cache,
+                                                               cairo_t                     *cr,
+                                                               const MurrineColors         *colors,
+                                                               const WidgetParameters      *widget,
+                                                               const ProgressBarParameters *progressbar,
+                                                               int x, int y, int width, int height,
+                                                               int first_offset, int offset);
+
+G_GNUC_INTERNAL void murrine_frame_cache_shutdown (void);
+
+#endif /* FRAME_CACHE_H */
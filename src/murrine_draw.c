@@ -25,7 +25,6 @@
 #include "murrine_types.h"
 #include "support.h"
 #include "cairo-support.h"
-#include "raico-blur.h"
 
 static void
 murrine_draw_inset (cairo_t *cr,
@@ -983,7 +982,6 @@ murrine_draw_progressbar_fill (cairo_t *cr,
                                int x, int y, int width, int height,
                                gint offset)
 {
-	double     tile_pos = 0;
 	double     stroke_width;
 	int        x_step;
 	int        roundness;
@@ -1066,19 +1064,7 @@ murrine_draw_progressbar_fill (cairo_t *cr,
 		case 1:
 		{
 			/* Draw strokes */
-			while (stroke_width > 0 && tile_pos <= width+x_step)
-			{
-				cairo_move_to (cr, stroke_width/2-x_step, 0);
-				cairo_line_to (cr, stroke_width-x_step, 0);
-				cairo_line_to (cr, stroke_width/2-x_step, height);
-				cairo_line_to (cr, -x_step, height);
-
-				cairo_translate (cr, stroke_width, 0);
-				tile_pos += stroke_width;
-			}
-
-			murrine_set_color_rgba (cr, &effect, 0.15);
-			cairo_fill (cr);
+			murrine_draw_progressbar_strokes (cr, &effect, width, height, x_step);
 			break;
 		}
 		case 2:
@@ -2534,12 +2520,6 @@ murrine_draw_menu_frame (cairo_t *cr,
 		{
 			const MurrineRGB *border = &colors->shade[2];
 			MurrineRGB fill;
-			raico_blur_t* blur = NULL;
-			cairo_t *cr_surface; 
-			cairo_surface_t *surface;
-			cairo_pattern_t *pat;
-			int bradius = 30;
-			int bheight = MIN (height, 300);
 
 			murrine_shade (&colors->bg[0], 1.14, &fill);
 
@@ -2548,38 +2528,13 @@ murrine_draw_menu_frame (cairo_t *cr,
 			cairo_stroke          (cr);
 
 			/* draw glow */
-			surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, bheight);
-			cr_surface = cairo_create (surface); 
-			blur = raico_blur_create (RAICO_BLUR_QUALITY_LOW);
-			raico_blur_set_radius (blur, bradius);
-			cairo_set_line_width (cr_surface, 1.0);
-			cairo_rectangle (cr_surface, bradius, bradius-15, width-bradius*2, bheight-bradius*2+15);
-			murrine_set_color_rgb (cr_surface, &fill);
-			cairo_fill (cr_surface);
-			raico_blur_apply (blur, surface);
-			cairo_rectangle (cr_surface, 0, -15, width, bheight+15);
-			pat = cairo_pattern_create_linear (0, -15, 0.0, bheight+15);
-			murrine_pattern_add_color_stop_rgba (pat, 0.25, &colors->bg[0], 0.0);
-			murrine_pattern_add_color_stop_rgba (pat, 1.0, &colors->bg[0], 1.0);
-			cairo_set_source (cr_surface, pat);
-			cairo_pattern_destroy (pat);
-			cairo_fill (cr_surface);
-			cairo_set_source_surface (cr, surface, 0, 0); 
-			cairo_paint (cr);
-			cairo_surface_destroy (surface); 
-			cairo_destroy (cr_surface);
+			murrine_draw_menu_glow (cr, &fill, &colors->bg[0], width, height);
 			break;
 		}
 		case 3:
 		{
 			MurrineRGB border;
 			MurrineRGB fill;
-			raico_blur_t* blur = NULL;
-			cairo_t *cr_surface; 
-			cairo_surface_t *surface;
-			cairo_pattern_t *pat;
-			int bradius = 30;
-			int bheight = MIN (height, 300);
 
 			murrine_shade (&colors->bg[0], murrine_get_contrast(1.1, widget->contrast), &border);
 			murrine_shade (&colors->bg[0], 0.96, &fill);
@@ -2589,26 +2544,7 @@ murrine_draw_menu_frame (cairo_t *cr,
 			cairo_stroke          (cr);
 
 			/* draw glow */
-			surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, bheight);
-			cr_surface = cairo_create (surface); 
-			blur = raico_blur_create (RAICO_BLUR_QUALITY_LOW);
-			raico_blur_set_radius (blur, bradius);
-			cairo_set_line_width (cr_surface, 1.0);
-			cairo_rectangle (cr_surface, bradius, bradius-15, width-bradius*2, bheight-bradius*2+15);
-			murrine_set_color_rgb (cr_surface, &fill);
-			cairo_fill (cr_surface);
-			raico_blur_apply (blur, surface);
-			cairo_rectangle (cr_surface, 0, -15, width, bheight+15);
-			pat = cairo_pattern_create_linear (0, -15, 0.0, bheight+15);
-			murrine_pattern_add_color_stop_rgba (pat, 0.25, &colors->bg[0], 0.0);
-			murrine_pattern_add_color_stop_rgba (pat, 1.0, &colors->bg[0], 1.0);
-			cairo_set_source (cr_surface, pat);
-			cairo_pattern_destroy (pat);
-			cairo_fill (cr_surface);
-			cairo_set_source_surface (cr, surface, 0, 0); 
-			cairo_paint (cr);
-			cairo_surface_destroy (surface); 
-			cairo_destroy (cr_surface);
+			murrine_draw_menu_glow (cr, &fill, &colors->bg[0], width, height);
 			break;
 		}
 	}
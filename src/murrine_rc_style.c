@@ -18,241 +18,359 @@
  *
  */
 
+#include <string.h>
+
 #include "murrine_style.h"
 #include "murrine_rc_style.h"
 
 #include "animation.h"
+#include "profile.h"
+#include "rc-cache.h"
+#include "rc-watch.h"
+#include "support.h"
 
-#ifdef HAVE_ANIMATION
 static void murrine_rc_style_finalize (GObject *object);
-#endif
 static GtkStyle *murrine_rc_style_create_style (GtkRcStyle *rc_style);
 static guint murrine_rc_style_parse (GtkRcStyle  *rc_style,
                                      GtkSettings *settings,
                                      GScanner    *scanner);
 static void murrine_rc_style_merge (GtkRcStyle *dest,
                                     GtkRcStyle *src);
+static void theme_options_copy (MurrineOptions       *dest,
+                                const MurrineOptions *src,
+                                guint64               flags);
 
-enum
+typedef enum
 {
-	TOKEN_ANIMATION = G_TOKEN_LAST + 1,
-	TOKEN_ARROWSTYLE,
-	TOKEN_BORDER_COLORS,
-	TOKEN_BORDER_SHADES,
-	TOKEN_COLORIZE_SCROLLBAR,
-	TOKEN_CELLSTYLE,
-	TOKEN_COMBOBOXSTYLE,
-	TOKEN_CONTRAST,
-	TOKEN_DEFAULT_BUTTON_COLOR,
-	TOKEN_EXPANDERSTYLE,
-	TOKEN_FOCUS_COLOR,
-	TOKEN_FOCUSSTYLE,
-	TOKEN_GLAZESTYLE,
-	TOKEN_GLOW_SHADE,
-	TOKEN_GLOWSTYLE,
-	TOKEN_GRADIENT_COLORS,
-	TOKEN_GRADIENT_SHADES,
-	TOKEN_HANDLESTYLE,
-	TOKEN_HIGHLIGHT_SHADE,
-	TOKEN_LIGHTBORDER_SHADE,
-	TOKEN_LIGHTBORDERSTYLE,
-	TOKEN_LISTVIEWHEADERSTYLE,
-	TOKEN_LISTVIEWSTYLE,
-	TOKEN_MENUBARITEMSTYLE,
-	TOKEN_MENUBARSTYLE,
-	TOKEN_MENUITEMSTYLE,
-	TOKEN_MENUSTYLE,
-	TOKEN_PRELIGHT_SHADE,
-	TOKEN_PROGRESSBARSTYLE,
-	TOKEN_RELIEFSTYLE,
-	TOKEN_RGBA,
-	TOKEN_ROUNDNESS,
-	TOKEN_SCROLLBARSTYLE,
-	TOKEN_SEPARATORSTYLE,
-	TOKEN_SHADOW_SHADES,
-	TOKEN_SLIDERSTYLE,
-	TOKEN_SPINBUTTONSTYLE,
-	TOKEN_STEPPERSTYLE,
-	TOKEN_TEXTSTYLE,
-	TOKEN_TEXT_SHADE,
-	TOKEN_TOOLBARSTYLE,
-	TOKEN_TREEVIEW_EXPANDER_COLOR,
-	TOKEN_TROUGH_BORDER_SHADES,
-	TOKEN_TROUGH_SHADES,	
-
-	TOKEN_TRUE,
-	TOKEN_FALSE,
+	THEME_OPTION_BOOLEAN,
+	THEME_OPTION_INT,
+	THEME_OPTION_SHADE,
+	THEME_OPTION_BORDER,          /* two shades */
+	THEME_OPTION_GRADIENT,        /* four shades */
+	THEME_OPTION_COLOR,
+	THEME_OPTION_BORDER_COLORS,
+	THEME_OPTION_GRADIENT_COLORS,
 
 	/* stuff to ignore */
-	TOKEN_GRADIENTS,
-	TOKEN_HILIGHT_RATIO,
-	TOKEN_HIGHLIGHT_RATIO,
-	TOKEN_LIGHTBORDER_RATIO,
-	TOKEN_PROFILE,
-	TOKEN_SCROLLBAR_COLOR,
-	TOKEN_SQUAREDSTYLE,
-	TOKEN_STYLE
-};
-
-static struct
+	THEME_OPTION_RATIO,           /* deprecated name of a shade */
+	THEME_OPTION_HILIGHT_RATIO,
+	THEME_OPTION_DUMMY,
+	THEME_OPTION_DUMMY_COLOR
+} ThemeOptionType;
+
+/* Every option has an entry, the first MRN_NUM_OPTIONS in the order of
+ * MurrineOptionId. It is parsed according to its type into the field at
+ * offset in MurrineOptions; the gboolean at has_offset, if there is one,
+ * tells whether the value is set. Merging copies size bytes. */
+typedef struct
 {
 	const gchar *name;
-	guint        token;
-}
-theme_symbols[] =
+	guint8       type;
+	guint8       id;
+	guint16      offset;
+	guint16      size;
+	guint16      has_offset;
+} ThemeOption;
+
+#define NO_FIELD G_MAXUINT16
+
+#define OPTION(name, type, id, field) \
+	{ name, type, id, G_STRUCT_OFFSET (MurrineOptions, field), sizeof (((MurrineOptions*) 0)->field), NO_FIELD }
+#define OPTION_HAS(name, type, id, field, has) \
+	{ name, type, id, G_STRUCT_OFFSET (MurrineOptions, field), sizeof (((MurrineOptions*) 0)->field), \
+	  G_STRUCT_OFFSET (MurrineOptions, has) }
+#define OPTION_DUMMY(name, type) \
+	{ name, type, MRN_NUM_OPTIONS, 0, 0, NO_FIELD }
+
+static const ThemeOption
+theme_options[] =
 {
-	{ "animation",           TOKEN_ANIMATION },
-	{ "arrowstyle",          TOKEN_ARROWSTYLE },
-	{ "border_colors",       TOKEN_BORDER_COLORS },
-	{ "border_shades",       TOKEN_BORDER_SHADES },
-	{ "colorize_scrollbar",  TOKEN_COLORIZE_SCROLLBAR },
-	{ "cellstyle",           TOKEN_CELLSTYLE },	
-	{ "comboboxstyle",       TOKEN_COMBOBOXSTYLE },
-	{ "contrast",            TOKEN_CONTRAST },
-	{ "default_button_color", TOKEN_DEFAULT_BUTTON_COLOR },
-	{ "expanderstyle",       TOKEN_EXPANDERSTYLE },
-	{ "focus_color",         TOKEN_FOCUS_COLOR },
-	{ "focusstyle",          TOKEN_FOCUSSTYLE },
-	{ "glazestyle",          TOKEN_GLAZESTYLE },
-	{ "glow_shade",          TOKEN_GLOW_SHADE },
-	{ "glowstyle",           TOKEN_GLOWSTYLE },
-	{ "gradient_colors",     TOKEN_GRADIENT_COLORS },
-	{ "gradient_shades",     TOKEN_GRADIENT_SHADES },
-	{ "handlestyle",         TOKEN_HANDLESTYLE },
-	{ "highlight_shade",     TOKEN_HIGHLIGHT_SHADE },
-	{ "lightborder_shade",   TOKEN_LIGHTBORDER_SHADE },
-	{ "lightborderstyle",    TOKEN_LIGHTBORDERSTYLE },
-	{ "listviewheaderstyle", TOKEN_LISTVIEWHEADERSTYLE },
-	{ "listviewstyle",       TOKEN_LISTVIEWSTYLE },
-	{ "menubaritemstyle",    TOKEN_MENUBARITEMSTYLE },
-	{ "menubarstyle",        TOKEN_MENUBARSTYLE },
-	{ "menuitemstyle",       TOKEN_MENUITEMSTYLE },
-	{ "menustyle",           TOKEN_MENUSTYLE },
-	{ "prelight_shade",      TOKEN_PRELIGHT_SHADE },
-	{ "progressbarstyle",    TOKEN_PROGRESSBARSTYLE },
-	{ "reliefstyle",         TOKEN_RELIEFSTYLE },
-	{ "rgba",                TOKEN_RGBA },
-	{ "roundness",           TOKEN_ROUNDNESS },
-	{ "scrollbarstyle",      TOKEN_SCROLLBARSTYLE },
-	{ "separatorstyle",      TOKEN_SEPARATORSTYLE },
-	{ "shadow_shades",       TOKEN_SHADOW_SHADES },
-	{ "sliderstyle",         TOKEN_SLIDERSTYLE },
-	{ "spinbuttonstyle",     TOKEN_SPINBUTTONSTYLE },
-	{ "stepperstyle",        TOKEN_STEPPERSTYLE },
-	{ "textstyle",           TOKEN_TEXTSTYLE },
-	{ "text_shade",          TOKEN_TEXT_SHADE },
-	{ "toolbarstyle",        TOKEN_TOOLBARSTYLE },
-	{ "treeview_expander_color", TOKEN_TREEVIEW_EXPANDER_COLOR },
-	{ "trough_border_shades", TOKEN_TROUGH_BORDER_SHADES },
-	{ "trough_shades",       TOKEN_TROUGH_SHADES },
-
-	{ "TRUE",                TOKEN_TRUE },
-	{ "FALSE",               TOKEN_FALSE },
+	OPTION ("animation",                 THEME_OPTION_BOOLEAN,    MRN_OPTION_ANIMATION,              animation),
+	OPTION ("arrowstyle",                THEME_OPTION_INT,        MRN_OPTION_ARROWSTYLE,             arrowstyle),
+	OPTION_HAS ("border_colors", THEME_OPTION_BORDER_COLORS, MRN_OPTION_BORDER_COLORS,
+	            border_colors, has_border_colors),
+	OPTION ("border_shades",             THEME_OPTION_BORDER,     MRN_OPTION_BORDER_SHADES,          border_shades),
+	OPTION ("cellstyle",                 THEME_OPTION_INT,        MRN_OPTION_CELLSTYLE,              cellstyle),
+	OPTION ("colorize_scrollbar",        THEME_OPTION_BOOLEAN,    MRN_OPTION_COLORIZE_SCROLLBAR,     colorize_scrollbar),
+	OPTION ("comboboxstyle",             THEME_OPTION_INT,        MRN_OPTION_COMBOBOXSTYLE,          comboboxstyle),
+	OPTION ("contrast",                  THEME_OPTION_SHADE,      MRN_OPTION_CONTRAST,               contrast),
+	OPTION_HAS ("default_button_color", THEME_OPTION_COLOR, MRN_OPTION_DEFAULT_BUTTON_COLOR,
+	            default_button_color, has_default_button_color),
+	OPTION ("expanderstyle",             THEME_OPTION_INT,        MRN_OPTION_EXPANDERSTYLE,          expanderstyle),
+	OPTION_HAS ("focus_color", THEME_OPTION_COLOR, MRN_OPTION_FOCUS_COLOR,
+	            focus_color, has_focus_color),
+	OPTION ("focusstyle",                THEME_OPTION_INT,        MRN_OPTION_FOCUSSTYLE,             focusstyle),
+	OPTION ("glazestyle",                THEME_OPTION_INT,        MRN_OPTION_GLAZESTYLE,             glazestyle),
+	OPTION ("glow_shade",                THEME_OPTION_SHADE,      MRN_OPTION_GLOW_SHADE,             glow_shade),
+	OPTION ("glowstyle",                 THEME_OPTION_INT,        MRN_OPTION_GLOWSTYLE,              glowstyle),
+	OPTION_HAS ("gradient_colors", THEME_OPTION_GRADIENT_COLORS, MRN_OPTION_GRADIENT_COLORS,
+	            gradient_colors, has_gradient_colors),
+	OPTION ("gradient_shades",           THEME_OPTION_GRADIENT,   MRN_OPTION_GRADIENT_SHADES,        gradient_shades),
+	OPTION ("handlestyle",               THEME_OPTION_INT,        MRN_OPTION_HANDLESTYLE,            handlestyle),
+	OPTION ("highlight_shade",           THEME_OPTION_SHADE,      MRN_OPTION_HIGHLIGHT_SHADE,        highlight_shade),
+	OPTION ("lightborder_shade",         THEME_OPTION_SHADE,      MRN_OPTION_LIGHTBORDER_SHADE,      lightborder_shade),
+	OPTION ("lightborderstyle",          THEME_OPTION_INT,        MRN_OPTION_LIGHTBORDERSTYLE,       lightborderstyle),
+	OPTION ("listviewheaderstyle",       THEME_OPTION_INT,        MRN_OPTION_LISTVIEWHEADERSTYLE,    listviewheaderstyle),
+	OPTION ("listviewstyle",             THEME_OPTION_INT,        MRN_OPTION_LISTVIEWSTYLE,          listviewstyle),
+	OPTION ("menubaritemstyle",          THEME_OPTION_INT,        MRN_OPTION_MENUBARITEMSTYLE,       menubaritemstyle),
+	OPTION ("menubarstyle",              THEME_OPTION_INT,        MRN_OPTION_MENUBARSTYLE,           menubarstyle),
+	OPTION ("menuitemstyle",             THEME_OPTION_INT,        MRN_OPTION_MENUITEMSTYLE,          menuitemstyle),
+	OPTION ("menustyle",                 THEME_OPTION_INT,        MRN_OPTION_MENUSTYLE,              menustyle),
+	OPTION ("prelight_shade",            THEME_OPTION_SHADE,      MRN_OPTION_PRELIGHT_SHADE,         prelight_shade),
+	OPTION ("progressbarstyle",          THEME_OPTION_INT,        MRN_OPTION_PROGRESSBARSTYLE,       progressbarstyle),
+	OPTION ("reliefstyle",               THEME_OPTION_INT,        MRN_OPTION_RELIEFSTYLE,            reliefstyle),
+	OPTION ("rgba",                      THEME_OPTION_BOOLEAN,    MRN_OPTION_RGBA,                   rgba),
+	OPTION ("roundness",                 THEME_OPTION_INT,        MRN_OPTION_ROUNDNESS,              roundness),
+	OPTION ("scrollbarstyle",            THEME_OPTION_INT,        MRN_OPTION_SCROLLBARSTYLE,         scrollbarstyle),
+	OPTION ("separatorstyle",            THEME_OPTION_INT,        MRN_OPTION_SEPARATORSTYLE,         separatorstyle),
+	OPTION ("shadow_shades",             THEME_OPTION_BORDER,     MRN_OPTION_SHADOW_SHADES,          shadow_shades),
+	OPTION ("sliderstyle",               THEME_OPTION_INT,        MRN_OPTION_SLIDERSTYLE,            sliderstyle),
+	OPTION ("spinbuttonstyle",           THEME_OPTION_INT,        MRN_OPTION_SPINBUTTONSTYLE,        spinbuttonstyle),
+	OPTION ("stepperstyle",              THEME_OPTION_INT,        MRN_OPTION_STEPPERSTYLE,           stepperstyle),
+	OPTION ("textstyle",                 THEME_OPTION_INT,        MRN_OPTION_TEXTSTYLE,              textstyle),
+	OPTION ("text_shade",                THEME_OPTION_SHADE,      MRN_OPTION_TEXT_SHADE,             text_shade),
+	OPTION ("toolbarstyle",              THEME_OPTION_INT,        MRN_OPTION_TOOLBARSTYLE,           toolbarstyle),
+	OPTION ("transition_durations",      THEME_OPTION_GRADIENT,   MRN_OPTION_TRANSITION_DURATIONS,   transition_durations),
+	OPTION_HAS ("treeview_expander_color", THEME_OPTION_COLOR, MRN_OPTION_TREEVIEW_EXPANDER_COLOR,
+	            treeview_expander_color, has_treeview_expander_color),
+	OPTION ("trough_border_shades",      THEME_OPTION_BORDER,     MRN_OPTION_TROUGH_BORDER_SHADES,   trough_border_shades),
+	OPTION ("trough_shades",             THEME_OPTION_BORDER,     MRN_OPTION_TROUGH_SHADES,          trough_shades),
 
 	/* stuff to ignore */
-	{ "gradients",           TOKEN_GRADIENTS },
-	{ "hilight_ratio",       TOKEN_HILIGHT_RATIO },
-	{ "highlight_ratio",     TOKEN_HIGHLIGHT_RATIO },
-	{ "lightborder_ratio",   TOKEN_LIGHTBORDER_RATIO },
-	{ "profile",             TOKEN_PROFILE },
-	{ "scrollbar_color",     TOKEN_SCROLLBAR_COLOR },
-	{ "squaredstyle",        TOKEN_SQUAREDSTYLE },
-	{ "style",               TOKEN_STYLE }
+	OPTION_DUMMY ("gradients",         THEME_OPTION_DUMMY),
+	OPTION ("hilight_ratio",           THEME_OPTION_HILIGHT_RATIO, MRN_OPTION_HIGHLIGHT_SHADE,   highlight_shade),
+	OPTION ("highlight_ratio",         THEME_OPTION_RATIO,    MRN_OPTION_HIGHLIGHT_SHADE,        highlight_shade),
+	OPTION ("lightborder_ratio",       THEME_OPTION_RATIO,    MRN_OPTION_LIGHTBORDER_SHADE,      lightborder_shade),
+	OPTION_DUMMY ("profile",           THEME_OPTION_DUMMY),
+	OPTION_DUMMY ("scrollbar_color",   THEME_OPTION_DUMMY_COLOR),
+	OPTION_DUMMY ("squaredstyle",      THEME_OPTION_DUMMY),
+	OPTION_DUMMY ("style",             THEME_OPTION_DUMMY)
 };
 
+#undef OPTION
+#undef OPTION_HAS
+#undef OPTION_DUMMY
+
+/* Options are found through a perfect hash: the seed was searched for so
+ * that no two option names share a slot. Adding an option may require a
+ * new seed, theme_options_init complains then and options are looked up
+ * one by one until a new seed is found. */
+#define THEME_OPTION_HASH_SEED 125415
+#define THEME_OPTION_HASH_BITS 7
+
+G_STATIC_ASSERT (G_N_ELEMENTS (theme_options) >= MRN_NUM_OPTIONS);
+G_STATIC_ASSERT (G_N_ELEMENTS (theme_options) < (1 << THEME_OPTION_HASH_BITS));
+
+static guint8   theme_option_slots[1 << THEME_OPTION_HASH_BITS];
+static gboolean theme_option_hashed = FALSE;
+
+/* Hash of where the options are in MurrineRcStyle, to tell cached
+ * records written by a build with another layout */
+static guint64 theme_options_layout;
+
+static guint
+theme_option_hash (const gchar *name)
+{
+	guint32 hash = THEME_OPTION_HASH_SEED;
+
+	for (; *name; name++)
+	{
+		hash ^= (guchar) *name;
+		hash *= 16777619;
+	}
+
+	return hash >> (32 - THEME_OPTION_HASH_BITS);
+}
+
+static void
+theme_options_init (void)
+{
+	const gsize record[] = { G_STRUCT_OFFSET (MurrineRcStyle, flags),
+	                         G_STRUCT_OFFSET (MurrineRcStyle, options),
+	                         sizeof (MurrineRcStyle) };
+	guint i;
+
+	theme_options_layout = murrine_hash_bytes64 (MRN_HASH64_INIT, record, sizeof (record));
+	for (i = 0; i < G_N_ELEMENTS (theme_options); i++)
+		theme_options_layout = murrine_hash_bytes64 (theme_options_layout, &theme_options[i].type,
+		                                             sizeof (ThemeOption) - G_STRUCT_OFFSET (ThemeOption, type));
+
+	theme_option_hashed = FALSE;
+	memset (theme_option_slots, 0, sizeof (theme_option_slots));
+
+	for (i = 0; i < G_N_ELEMENTS (theme_options); i++)
+	{
+		guint slot = theme_option_hash (theme_options[i].name);
+
+		g_return_if_fail (i >= MRN_NUM_OPTIONS || theme_options[i].id == i);
+		g_return_if_fail (theme_option_slots[slot] == 0);
+		theme_option_slots[slot] = i + 1;
+	}
+
+	theme_option_hashed = TRUE;
+}
+
+static const ThemeOption*
+theme_option_lookup (const gchar *name)
+{
+	guint8 index;
+
+	if (G_UNLIKELY (!theme_option_hashed))
+	{
+		for (index = 0; index < G_N_ELEMENTS (theme_options); index++)
+			if (strcmp (theme_options[index].name, name) == 0)
+				return &theme_options[index];
+
+		return NULL;
+	}
+
+	index = theme_option_slots[theme_option_hash (name)];
+	if (index == 0 || strcmp (theme_options[index - 1].name, name) != 0)
+		return NULL;
+
+	return &theme_options[index - 1];
+}
+
 G_DEFINE_DYNAMIC_TYPE (XamarinRcStyle, murrine_rc_style, GTK_TYPE_RC_STYLE)
 
+/* An engine block, identified by the gtkrc it is in and by how many
+ * blocks of this engine precede it there, with the options it sets */
+struct _MurrineRcSource
+{
+	gchar          *filename;
+	guint           index;
+	guint64         flags;
+	MurrineOptions  options;
+};
+
+/* Every MurrineRcStyle, most recently created first */
+static GList *rc_styles = NULL;
+
+static void
+murrine_rc_source_free (MurrineRcSource *source)
+{
+	if (source == NULL)
+		return;
+
+	g_free (source->filename);
+	g_free (source);
+}
+
 void
 murrine_rc_style_register_types (GTypeModule *module)
 {
 	murrine_rc_style_register_type (module);
 }
 
+static void
+theme_options_set_defaults (MurrineOptions *options)
+{
+	options->animation = FALSE;
+	options->arrowstyle = 0;
+	options->border_shades[0] = 1.0;
+	options->border_shades[1] = 1.0;
+	options->cellstyle = 1;
+	options->colorize_scrollbar = TRUE;
+	options->comboboxstyle = 0;
+	options->contrast = 1.0;
+	options->expanderstyle = 0;
+	options->focusstyle = 2;
+	options->has_border_colors = FALSE;
+	options->has_default_button_color = FALSE;
+	options->has_gradient_colors = FALSE;
+	options->has_treeview_expander_color = FALSE;
+	options->handlestyle = 0;
+	options->glazestyle = 1;
+	options->glow_shade = 1.0;
+	options->glowstyle = 0;
+	options->gradient_shades[0] = 1.1;
+	options->gradient_shades[1] = 1.0;
+	options->gradient_shades[2] = 1.0;
+	options->gradient_shades[3] = 1.1;
+	options->highlight_shade = 1.1;
+	options->lightborder_shade = 1.1;
+	options->lightborderstyle = 0;
+	options->listviewheaderstyle = 1;
+	options->listviewstyle = 0;
+	options->menubaritemstyle = 0;
+	options->menubarstyle = 0;
+	options->menuitemstyle = 1;
+	options->menustyle = 1;
+	options->prelight_shade = 1.04;
+	options->progressbarstyle = 1;
+	options->reliefstyle = 2;
+	options->rgba = FALSE;
+	options->roundness = 1;
+	options->scrollbarstyle = 0;
+	options->separatorstyle = 0;
+	options->shadow_shades[0] = 1.0;
+	options->shadow_shades[1] = 1.0;
+	options->sliderstyle = 0;
+	options->spinbuttonstyle = 0;
+	options->stepperstyle = 0;
+	options->textstyle = 0;
+	options->text_shade = 1.12;
+	options->toolbarstyle = 0;
+	options->transition_durations[MRN_TRANSITION_PRELIGHT] = 0.2;
+	options->transition_durations[MRN_TRANSITION_ACTIVE] = 0.1;
+	options->transition_durations[MRN_TRANSITION_FOCUS] = 0.25;
+	options->transition_durations[MRN_TRANSITION_SLIDER] = 0.2;
+	options->trough_border_shades[0] = 1.0;
+	options->trough_border_shades[1] = 1.0;
+	options->trough_shades[0] = 1.0;
+	options->trough_shades[1] = 1.0;
+}
+
 static void
 murrine_rc_style_init (MurrineRcStyle *murrine_rc)
 {
+	murrine_rc->source = NULL;
+	murrine_rc->merged = NULL;
 	murrine_rc->flags = 0;
 
-	murrine_rc->animation = FALSE;
-	murrine_rc->arrowstyle = 0;
-	murrine_rc->border_shades[0] = 1.0;
-	murrine_rc->border_shades[1] = 1.0;
-	murrine_rc->cellstyle = 1;
-	murrine_rc->colorize_scrollbar = TRUE;
-	murrine_rc->comboboxstyle = 0;
-	murrine_rc->contrast = 1.0;
-	murrine_rc->expanderstyle = 0;
-	murrine_rc->focusstyle = 2;
-	murrine_rc->has_border_colors = FALSE;
-	murrine_rc->has_default_button_color = FALSE;
-	murrine_rc->has_gradient_colors = FALSE;
-	murrine_rc->has_treeview_expander_color = FALSE;
-	murrine_rc->handlestyle = 0;
-	murrine_rc->glazestyle = 1;
-	murrine_rc->glow_shade = 1.0;
-	murrine_rc->glowstyle = 0;
-	murrine_rc->gradient_shades[0] = 1.1;
-	murrine_rc->gradient_shades[1] = 1.0;
-	murrine_rc->gradient_shades[2] = 1.0;
-	murrine_rc->gradient_shades[3] = 1.1;
-	murrine_rc->highlight_shade = 1.1;
-	murrine_rc->lightborder_shade = 1.1;
-	murrine_rc->lightborderstyle = 0;
-	murrine_rc->listviewheaderstyle = 1;
-	murrine_rc->listviewstyle = 0;
-	murrine_rc->menubaritemstyle = 0;
-	murrine_rc->menubarstyle = 0;
-	murrine_rc->menuitemstyle = 1;
-	murrine_rc->menustyle = 1;
-	murrine_rc->prelight_shade = 1.04;
-	murrine_rc->progressbarstyle = 1;
-	murrine_rc->reliefstyle = 2;
-	murrine_rc->rgba = FALSE;
-	murrine_rc->roundness = 1;
-	murrine_rc->scrollbarstyle = 0;
-	murrine_rc->separatorstyle = 0;
-	murrine_rc->shadow_shades[0] = 1.0;
-	murrine_rc->shadow_shades[1] = 1.0;
-	murrine_rc->sliderstyle = 0;
-	murrine_rc->spinbuttonstyle = 0;
-	murrine_rc->stepperstyle = 0;
-	murrine_rc->textstyle = 0;
-	murrine_rc->text_shade = 1.12;
-	murrine_rc->toolbarstyle = 0;
-	murrine_rc->trough_border_shades[0] = 1.0;
-	murrine_rc->trough_border_shades[1] = 1.0;
-	murrine_rc->trough_shades[0] = 1.0;
-	murrine_rc->trough_shades[1] = 1.0;
-}
+	theme_options_set_defaults (&murrine_rc->options);
+
+	rc_styles = g_list_prepend (rc_styles, murrine_rc);
 
 #ifdef HAVE_ANIMATION
+	murrine_animation_ref ();
+#endif
+}
+
 static void
 murrine_rc_style_finalize (GObject *object)
 {
-	/* cleanup all the animation stuff */
-	murrine_animation_cleanup ();
+	MurrineRcStyle *murrine_rc = MURRINE_RC_STYLE (object);
+
+	rc_styles = g_list_remove (rc_styles, murrine_rc);
+
+	murrine_rc_source_free (murrine_rc->source);
+	g_slist_foreach (murrine_rc->merged, (GFunc) g_object_unref, NULL);
+	g_slist_free (murrine_rc->merged);
+
+#ifdef HAVE_ANIMATION
+	/* cleanup all the animation stuff once no rc style is left */
+	murrine_animation_unref ();
+#endif
 
 	if (G_OBJECT_CLASS (murrine_rc_style_parent_class)->finalize != NULL)
 		G_OBJECT_CLASS (murrine_rc_style_parent_class)->finalize(object);
 }
-#endif
 
 
 static void
 murrine_rc_style_class_init (MurrineRcStyleClass *klass)
 {
 	GtkRcStyleClass *rc_style_class = GTK_RC_STYLE_CLASS (klass);
-#ifdef HAVE_ANIMATION
 	GObjectClass    *g_object_class = G_OBJECT_CLASS (klass);
-#endif
 
 	rc_style_class->parse = murrine_rc_style_parse;
 	rc_style_class->create_style = murrine_rc_style_create_style;
 	rc_style_class->merge = murrine_rc_style_merge;
 
-#ifdef HAVE_ANIMATION
+	theme_options_init ();
+
 	g_object_class->finalize = murrine_rc_style_finalize;
-#endif
 }
 
 static void
@@ -260,6 +378,12 @@ murrine_rc_style_class_finalize (MurrineRcStyleClass *klass)
 {
 }
 
+static gboolean
+theme_token_is (GScanner *scanner, guint token, const gchar *identifier)
+{
+	return token == G_TOKEN_IDENTIFIER && strcmp (scanner->value.v_identifier, identifier) == 0;
+}
+
 static guint
 theme_parse_boolean (GtkSettings *settings,
                      GScanner     *scanner,
@@ -267,24 +391,38 @@ theme_parse_boolean (GtkSettings *settings,
 {
 	guint token;
 
-	/* Skip 'ANIMATION' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
 
 	token = g_scanner_get_next_token(scanner);
-	if (token == TOKEN_TRUE)
+	if (theme_token_is (scanner, token, "TRUE"))
 		*retval = TRUE;
-	else if (token == TOKEN_FALSE)
+	else if (theme_token_is (scanner, token, "FALSE"))
 		*retval = FALSE;
 	else
-		return TOKEN_TRUE;
+		return G_TOKEN_IDENTIFIER;
 
 	return G_TOKEN_NONE;
 }
 
+/* A color given as a string or as { r, g, b } only depends on the block.
+ * Anything else, @name or an expression like shade (), may refer to a
+ * symbolic color defined in another gtkrc, which keeps the block out of
+ * the rc cache. */
+static guint
+theme_parse_color_value (GScanner   *scanner,
+                         GtkRcStyle *style,
+                         GdkColor   *color)
+{
+	guint token = g_scanner_peek_next_token (scanner);
+
+	if (token != G_TOKEN_STRING && token != G_TOKEN_LEFT_CURLY)
+		g_datalist_set_data (&scanner->qdata, "murrine-rc-symbolic", GUINT_TO_POINTER (TRUE));
+
+	return gtk_rc_parse_color_full (scanner, style, color);
+}
+
 static guint
 theme_parse_color (GtkSettings  *settings,
                    GScanner     *scanner,
@@ -293,14 +431,11 @@ theme_parse_color (GtkSettings  *settings,
 {
 	guint token;
 
-	/* Skip 'blah_color' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
 
-	return gtk_rc_parse_color_full (scanner, style, color);
+	return theme_parse_color_value (scanner, style, color);
 }
 
 static guint
@@ -312,19 +447,15 @@ murrine_gtk2_rc_parse_dummy_color (GtkSettings      *settings,
 {
 	guint token;
 
-	/* Skip option */
-	token = g_scanner_get_next_token (scanner);
-
 	/* print a warning. Isn't there a way to get the string from the scanner? */
 	g_scanner_warn (scanner, "Murrine configuration option \"%s\" is no longer supported and will be ignored.", name);
 
 	/* equal sign */
-	/* Skip 'blah_color' */
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
 
-	return  gtk_rc_parse_color_full (scanner, style, color);
+	return theme_parse_color_value (scanner, style, color);
 }
 
 static guint
@@ -334,9 +465,6 @@ theme_parse_shade (GtkSettings  *settings,
 {
 	guint token;
 
-	/* Skip 'ratio' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
@@ -357,9 +485,6 @@ theme_parse_int (GtkSettings  *settings,
 {
 	guint token;
 
-	/* Skip '*style' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
@@ -380,9 +505,6 @@ theme_parse_gradient (GtkSettings  *settings,
 {
 	guint               token;
 
-	/* Skip 'blah_border' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
@@ -439,15 +561,12 @@ theme_parse_gradient_colors (GtkSettings  *settings,
 	guint token;
 	*retval = TRUE;
 
-	/* Skip 'blah_border' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
 
 	token = g_scanner_get_next_token(scanner);
-	if (token == TOKEN_FALSE)
+	if (theme_token_is (scanner, token, "FALSE"))
 	{
 		*retval = FALSE;
 		return G_TOKEN_NONE;
@@ -455,22 +574,22 @@ theme_parse_gradient_colors (GtkSettings  *settings,
 	else if (token != G_TOKEN_LEFT_CURLY)
 		return G_TOKEN_LEFT_CURLY;
 
-	gtk_rc_parse_color_full (scanner, style, &gradient_colors[0]);
+	theme_parse_color_value (scanner, style, &gradient_colors[0]);
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_COMMA)
 		return G_TOKEN_COMMA;
 
-	gtk_rc_parse_color_full (scanner, style, &gradient_colors[1]);
+	theme_parse_color_value (scanner, style, &gradient_colors[1]);
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_COMMA)
 		return G_TOKEN_COMMA;
 
-	gtk_rc_parse_color_full (scanner, style, &gradient_colors[2]);
+	theme_parse_color_value (scanner, style, &gradient_colors[2]);
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_COMMA)
 		return G_TOKEN_COMMA;
 
-	gtk_rc_parse_color_full (scanner, style, &gradient_colors[3]);
+	theme_parse_color_value (scanner, style, &gradient_colors[3]);
 
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_RIGHT_CURLY)
@@ -491,15 +610,12 @@ theme_parse_border_colors (GtkSettings  *settings,
 	guint token;
 	*retval = TRUE;
 
-	/* Skip 'blah_border' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
 
 	token = g_scanner_get_next_token(scanner);
-	if (token == TOKEN_FALSE)
+	if (theme_token_is (scanner, token, "FALSE"))
 	{
 		*retval = FALSE;
 		return G_TOKEN_NONE;
@@ -507,12 +623,12 @@ theme_parse_border_colors (GtkSettings  *settings,
 	else if (token != G_TOKEN_LEFT_CURLY)
 		return G_TOKEN_LEFT_CURLY;
 
-	gtk_rc_parse_color_full (scanner, style, &border_colors[0]);
+	theme_parse_color_value (scanner, style, &border_colors[0]);
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_COMMA)
 		return G_TOKEN_COMMA;
 
-	gtk_rc_parse_color_full (scanner, style, &border_colors[1]);
+	theme_parse_color_value (scanner, style, &border_colors[1]);
 
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_RIGHT_CURLY)
@@ -530,9 +646,6 @@ theme_parse_border (GtkSettings  *settings,
 {
 	guint               token;
 
-	/* Skip 'blah_border' */
-	token = g_scanner_get_next_token(scanner);
-
 	token = g_scanner_get_next_token(scanner);
 	if (token != G_TOKEN_EQUAL_SIGN)
 		return G_TOKEN_EQUAL_SIGN;
@@ -570,9 +683,6 @@ murrine_gtk2_rc_parse_dummy (GtkSettings      *settings,
 {
 	guint token;
 
-	/* Skip option */
-	token = g_scanner_get_next_token (scanner);
-
 	/* print a warning. Isn't there a way to get the string from the scanner? */
 	g_scanner_warn (scanner, "Murrine configuration option \"%s\" is no longer supported and will be ignored.", name);
 
@@ -588,277 +698,296 @@ murrine_gtk2_rc_parse_dummy (GtkSettings      *settings,
 }
 
 static guint
-murrine_rc_style_parse (GtkRcStyle *rc_style,
-                        GtkSettings  *settings,
-                        GScanner   *scanner)
+theme_parse_option (GtkSettings       *settings,
+                    GScanner          *scanner,
+                    GtkRcStyle        *rc_style,
+                    const ThemeOption *option)
 {
-	static GQuark scope_id = 0;
-	MurrineRcStyle *murrine_style = MURRINE_RC_STYLE (rc_style);
+	MurrineRcStyle *murrine_rc = MURRINE_RC_STYLE (rc_style);
+	gpointer field = G_STRUCT_MEMBER_P (&murrine_rc->options, option->offset);
+	guint token;
+
+	switch (option->type)
+	{
+		case THEME_OPTION_BOOLEAN:
+			token = theme_parse_boolean (settings, scanner, field);
+			break;
+		case THEME_OPTION_INT:
+			token = theme_parse_int (settings, scanner, field);
+			break;
+		case THEME_OPTION_SHADE:
+			token = theme_parse_shade (settings, scanner, field);
+			break;
+		case THEME_OPTION_BORDER:
+			token = theme_parse_border (settings, scanner, field);
+			break;
+		case THEME_OPTION_GRADIENT:
+			token = theme_parse_gradient (settings, scanner, field);
+			break;
+		case THEME_OPTION_COLOR:
+			token = theme_parse_color (settings, scanner, rc_style, field);
+			break;
+		case THEME_OPTION_BORDER_COLORS:
+			token = theme_parse_border_colors (settings, scanner, rc_style,
+			                                   G_STRUCT_MEMBER_P (&murrine_rc->options, option->has_offset), field);
+			break;
+		case THEME_OPTION_GRADIENT_COLORS:
+			token = theme_parse_gradient_colors (settings, scanner, rc_style,
+			                                     G_STRUCT_MEMBER_P (&murrine_rc->options, option->has_offset), field);
+			break;
+
+		/* stuff to ignore */
+		case THEME_OPTION_RATIO:
+		case THEME_OPTION_HILIGHT_RATIO:
+			g_scanner_warn (scanner, "Murrine configuration option \"%s\" will be deprecated in future releases. Please use \"%s\" instead.", option->name, theme_options[option->id].name);
+			token = theme_parse_shade (settings, scanner, field);
+			if (option->type == THEME_OPTION_HILIGHT_RATIO)
+				*(double*) field /= 0.909090;
+			break;
+		case THEME_OPTION_DUMMY:
+			token = murrine_gtk2_rc_parse_dummy (settings, scanner, (gchar*) option->name);
+			break;
+		case THEME_OPTION_DUMMY_COLOR:
+		{
+			GdkColor dummy_color;
+			token = murrine_gtk2_rc_parse_dummy_color (settings, scanner, (gchar*) option->name, rc_style, &dummy_color);
+			break;
+		}
+		default:
+			g_assert_not_reached ();
+			token = G_TOKEN_NONE;
+			break;
+	}
 
+	if (token != G_TOKEN_NONE)
+		return token;
+
+	if (option->has_offset != NO_FIELD && option->type == THEME_OPTION_COLOR)
+		G_STRUCT_MEMBER (gboolean, &murrine_rc->options, option->has_offset) = TRUE;
+	if (option->id < MRN_NUM_OPTIONS)
+		murrine_rc->flags |= MRN_OPTION_FLAG (option->id);
+
+	return G_TOKEN_NONE;
+}
+
+static guint
+murrine_rc_style_parse_options (GtkRcStyle *rc_style,
+                                GtkSettings  *settings,
+                                GScanner   *scanner)
+{
+	static GQuark scope_id = 0;
+	const ThemeOption *option;
 	guint old_scope;
 	guint token;
-	guint i;
-
-	/* Set up a new scope in this scanner. */
 
+	/* Option names come in as identifiers and are looked up in
+	 * theme_options, an empty scope keeps the scanner from turning them
+	 * into gtkrc symbols. */
 	if (!scope_id)
 		scope_id = g_quark_from_string("murrine_theme_engine");
 
-	/* If we bail out due to errors, we *don't* reset the scope, so the
-	* error messaging code can make sense of our tokens.
-	*/
 	old_scope = g_scanner_set_scope(scanner, scope_id);
 
-	/* Now check if we already added our symbols to this scope
-	* (in some previous call to murrine_rc_style_parse for the
-	* same scanner.
-	*/
-
-	if (!g_scanner_lookup_symbol(scanner, theme_symbols[0].name))
+	token = g_scanner_get_next_token(scanner);
+	while (token != G_TOKEN_RIGHT_CURLY)
 	{
-		g_scanner_freeze_symbol_table(scanner);
-		for (i = 0; i < G_N_ELEMENTS (theme_symbols); i++)
-			g_scanner_scope_add_symbol(scanner, scope_id, theme_symbols[i].name, GINT_TO_POINTER(theme_symbols[i].token));
-		g_scanner_thaw_symbol_table(scanner);
+		option = NULL;
+		if (token == G_TOKEN_IDENTIFIER)
+			option = theme_option_lookup (scanner->value.v_identifier);
+
+		if (option == NULL)
+			token = G_TOKEN_RIGHT_CURLY;
+		else
+			token = theme_parse_option (settings, scanner, rc_style, option);
+
+		if (token != G_TOKEN_NONE)
+		{
+			g_scanner_set_scope(scanner, old_scope);
+			return token;
+		}
+
+		token = g_scanner_get_next_token(scanner);
 	}
 
-	/* We're ready to go, now parse the top level */
-	token = g_scanner_peek_next_token(scanner);
-	while (token != G_TOKEN_RIGHT_CURLY)
+	g_scanner_set_scope(scanner, old_scope);
+
+	return G_TOKEN_NONE;
+}
+
+/* The options of a MurrineRcStyle, as they are kept in the theme cache */
+#define RC_OPTIONS_OFFSET G_STRUCT_OFFSET (MurrineRcStyle, flags)
+#define RC_OPTIONS_SIZE   (sizeof (MurrineRcStyle) - RC_OPTIONS_OFFSET)
+#define RC_OPTIONS_LAYOUT theme_options_layout
+
+static guint
+murrine_rc_style_skip_block (GScanner *scanner)
+{
+	guint depth = 1;
+
+	while (depth > 0)
 	{
-		switch (token)
+		switch (g_scanner_get_next_token (scanner))
 		{
-			case TOKEN_ANIMATION:
-				token = theme_parse_boolean (settings, scanner, &murrine_style->animation);
-				murrine_style->bflags |= MRN_FLAG_ANIMATION;
-				break;
-			case TOKEN_ARROWSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->arrowstyle);
-				murrine_style->flags |= MRN_FLAG_ARROWSTYLE;
-				break;
-			case TOKEN_BORDER_COLORS:
-				token = theme_parse_border_colors (settings, scanner, rc_style, &murrine_style->has_border_colors, murrine_style->border_colors);
-				murrine_style->gflags |= MRN_FLAG_BORDER_COLORS;
-				break;
-			case TOKEN_BORDER_SHADES:
-				token = theme_parse_border (settings, scanner, murrine_style->border_shades);
-				murrine_style->gflags |= MRN_FLAG_BORDER_SHADES;
-				break;
-			case TOKEN_CELLSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->cellstyle);
-				murrine_style->flags |= MRN_FLAG_CELLSTYLE;
-				break;
-			case TOKEN_COLORIZE_SCROLLBAR:
-				token = theme_parse_boolean (settings, scanner, &murrine_style->colorize_scrollbar);
-				murrine_style->bflags |= MRN_FLAG_COLORIZE_SCROLLBAR;
-				break;
-			case TOKEN_COMBOBOXSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->comboboxstyle);
-				murrine_style->flags |= MRN_FLAG_COMBOBOXSTYLE;
-				break;
-			case TOKEN_CONTRAST:
-				token = theme_parse_shade (settings, scanner, &murrine_style->contrast);
-				murrine_style->bflags |= MRN_FLAG_CONTRAST;
-				break;
-			case TOKEN_DEFAULT_BUTTON_COLOR:
-				token = theme_parse_color (settings, scanner, rc_style, &murrine_style->default_button_color);
-				murrine_style->flags |= MRN_FLAG_DEFAULT_BUTTON_COLOR;
-				break;
-			case TOKEN_EXPANDERSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->expanderstyle);
-				murrine_style->flags |= MRN_FLAG_EXPANDERSTYLE;
-				break;
-			case TOKEN_FOCUS_COLOR:
-				token = theme_parse_color (settings, scanner, rc_style, &murrine_style->focus_color);
-				murrine_style->flags |= MRN_FLAG_FOCUS_COLOR;
-				break;
-			case TOKEN_FOCUSSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->focusstyle);
-				murrine_style->flags |= MRN_FLAG_FOCUSSTYLE;
-				break;
-			case TOKEN_GLAZESTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->glazestyle);
-				murrine_style->flags |= MRN_FLAG_GLAZESTYLE;
-				break;
-			case TOKEN_GLOW_SHADE:
-				token = theme_parse_shade (settings, scanner, &murrine_style->glow_shade);
-				murrine_style->flags |= MRN_FLAG_GLOW_SHADE;
-				break;
-			case TOKEN_GLOWSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->glowstyle);
-				murrine_style->flags |= MRN_FLAG_GLOWSTYLE;
-				break;
-			case TOKEN_GRADIENT_COLORS:
-				token = theme_parse_gradient_colors (settings, scanner, rc_style, &murrine_style->has_gradient_colors, murrine_style->gradient_colors);
-				murrine_style->gflags |= MRN_FLAG_GRADIENT_COLORS;
-				break;
-			case TOKEN_GRADIENT_SHADES:
-				token = theme_parse_gradient (settings, scanner, murrine_style->gradient_shades);
-				murrine_style->gflags |= MRN_FLAG_GRADIENT_SHADES;
-				break;
-			case TOKEN_HANDLESTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->handlestyle);
-				murrine_style->flags |= MRN_FLAG_HANDLESTYLE;
-				break;
-			case TOKEN_HIGHLIGHT_SHADE:
-				token = theme_parse_shade (settings, scanner, &murrine_style->highlight_shade);
-				murrine_style->flags |= MRN_FLAG_HIGHLIGHT_SHADE;
-				break;
-			case TOKEN_LIGHTBORDER_SHADE:
-				token = theme_parse_shade (settings, scanner, &murrine_style->lightborder_shade);
-				murrine_style->flags |= MRN_FLAG_LIGHTBORDER_SHADE;
-				break;
-			case TOKEN_LIGHTBORDERSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->lightborderstyle);
-				murrine_style->flags |= MRN_FLAG_LIGHTBORDERSTYLE;
+			case G_TOKEN_LEFT_CURLY:
+				depth++;
 				break;
-			case TOKEN_LISTVIEWHEADERSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->listviewheaderstyle);
-				murrine_style->flags |= MRN_FLAG_LISTVIEWHEADERSTYLE;
+			case G_TOKEN_RIGHT_CURLY:
+				depth--;
 				break;
-			case TOKEN_LISTVIEWSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->listviewstyle);
-				murrine_style->flags |= MRN_FLAG_LISTVIEWSTYLE;
-				break;
-			case TOKEN_MENUBARITEMSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->menubaritemstyle);
-				murrine_style->flags |= MRN_FLAG_MENUBARITEMSTYLE;
-				break;
-			case TOKEN_MENUBARSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->menubarstyle);
-				murrine_style->flags |= MRN_FLAG_MENUBARSTYLE;
-				break;
-			case TOKEN_MENUITEMSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->menuitemstyle);
-				murrine_style->flags |= MRN_FLAG_MENUITEMSTYLE;
-				break;
-			case TOKEN_MENUSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->menustyle);
-				murrine_style->flags |= MRN_FLAG_MENUSTYLE;
-				break;
-			case TOKEN_PRELIGHT_SHADE:
-				token = theme_parse_shade (settings, scanner, &murrine_style->prelight_shade);
-				murrine_style->flags |= MRN_FLAG_PRELIGHT_SHADE;
-				break;
-			case TOKEN_PROGRESSBARSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->progressbarstyle);
-				murrine_style->flags |= MRN_FLAG_PROGRESSBARSTYLE;
-				break;
-			case TOKEN_RELIEFSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->reliefstyle);
-				murrine_style->flags |= MRN_FLAG_RELIEFSTYLE;
-				break;
-			case TOKEN_RGBA:
-				token = theme_parse_boolean (settings, scanner, &murrine_style->rgba);
-				murrine_style->bflags |= MRN_FLAG_RGBA;
-				break;
-			case TOKEN_ROUNDNESS:
-				token = theme_parse_int (settings, scanner, &murrine_style->roundness);
-				murrine_style->bflags |= MRN_FLAG_ROUNDNESS;
-				break;
-			case TOKEN_SCROLLBARSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->scrollbarstyle);
-				murrine_style->flags |= MRN_FLAG_SCROLLBARSTYLE;
-				break;
-			case TOKEN_SEPARATORSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->separatorstyle);
-				murrine_style->flags |= MRN_FLAG_SEPARATORSTYLE;
-				break;
-			case TOKEN_SHADOW_SHADES:
-				token = theme_parse_border (settings, scanner, murrine_style->shadow_shades);
-				murrine_style->gflags |= MRN_FLAG_SHADOW_SHADES;
-				break;
-			case TOKEN_SLIDERSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->sliderstyle);
-				murrine_style->flags |= MRN_FLAG_SLIDERSTYLE;
-				break;
-			case TOKEN_SPINBUTTONSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->spinbuttonstyle);
-				murrine_style->flags |= MRN_FLAG_SPINBUTTONSTYLE;
-				break;
-			case TOKEN_STEPPERSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->stepperstyle);
-				murrine_style->flags |= MRN_FLAG_STEPPERSTYLE;
-				break;
-			case TOKEN_TEXTSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->textstyle);
-				murrine_style->flags |= MRN_FLAG_TEXTSTYLE;
-				break;
-			case TOKEN_TEXT_SHADE:
-				token = theme_parse_shade (settings, scanner, &murrine_style->text_shade);
-				murrine_style->flags |= MRN_FLAG_TEXT_SHADE;
-				break;
-			case TOKEN_TREEVIEW_EXPANDER_COLOR:
-				token = theme_parse_color (settings, scanner, rc_style, &murrine_style->treeview_expander_color);
-				murrine_style->has_treeview_expander_color = TRUE;
-				break;
-			case TOKEN_TOOLBARSTYLE:
-				token = theme_parse_int (settings, scanner, &murrine_style->toolbarstyle);
-				murrine_style->flags |= MRN_FLAG_TOOLBARSTYLE;
-				break;
-			case TOKEN_TROUGH_BORDER_SHADES:
-				token = theme_parse_border (settings, scanner, murrine_style->trough_border_shades);
-				murrine_style->gflags |= MRN_FLAG_TROUGH_BORDER_SHADES;
-				break;
-			case TOKEN_TROUGH_SHADES:
-				token = theme_parse_border (settings, scanner, murrine_style->trough_shades);
-				murrine_style->gflags |= MRN_FLAG_TROUGH_SHADES;
-				break;
-
-			/* stuff to ignore */
-			case TOKEN_GRADIENTS:
-				token = murrine_gtk2_rc_parse_dummy (settings, scanner, "gradients");
-				break;
-			case TOKEN_HILIGHT_RATIO:
-				g_scanner_warn (scanner, "Murrine configuration option \"hilight_ratio\" will be deprecated in future releases. Please use \"highlight_shade\" instead.", "hilight_ratio");
-				double hilight_ratio;
-				token = theme_parse_shade (settings, scanner, &hilight_ratio);
-				murrine_style->highlight_shade = hilight_ratio/0.909090;
-				murrine_style->flags |= MRN_FLAG_HIGHLIGHT_SHADE;
-				break;
-			case TOKEN_HIGHLIGHT_RATIO:
-				g_scanner_warn (scanner, "Murrine configuration option \"highlight_ratio\" will be deprecated in future releases. Please use \"highlight_shade\" instead.", "highlight_ratio");
-				token = theme_parse_shade (settings, scanner, &murrine_style->highlight_shade);
-				murrine_style->flags |= MRN_FLAG_HIGHLIGHT_SHADE;
-				break;
-			case TOKEN_LIGHTBORDER_RATIO:
-				g_scanner_warn (scanner, "Murrine configuration option \"lightborder_ratio\" will be deprecated in future releases. Please use \"lightborder_shade\" instead.", "lightborder_ratio");
-				token = theme_parse_shade (settings, scanner, &murrine_style->lightborder_shade);
-				murrine_style->flags |= MRN_FLAG_LIGHTBORDER_SHADE;
-				break;
-			case TOKEN_PROFILE:
-				token = murrine_gtk2_rc_parse_dummy (settings, scanner, "profile");
-				break;
-			case TOKEN_SCROLLBAR_COLOR:
-			{
-				GdkColor dummy_color;
-				token = murrine_gtk2_rc_parse_dummy_color (settings, scanner, "scrollbar_color", rc_style, &dummy_color);
-				break;
-			}
-			case TOKEN_SQUAREDSTYLE:
-				token = murrine_gtk2_rc_parse_dummy (settings, scanner, "squaredstyle");
-				break;
-			case TOKEN_STYLE:
-				token = murrine_gtk2_rc_parse_dummy (settings, scanner, "style");
-				break;
-
+			case G_TOKEN_EOF:
+				return G_TOKEN_RIGHT_CURLY;
 			default:
-				g_scanner_get_next_token(scanner);
-				token = G_TOKEN_RIGHT_CURLY;
 				break;
 		}
+	}
 
-		if (token != G_TOKEN_NONE)
-			return token;
+	return G_TOKEN_NONE;
+}
 
-		token = g_scanner_peek_next_token(scanner);
+/* Remembers the block parsed into the style, with the options it sets,
+ * so that murrine_rc_style_reload () can find it again */
+static void
+murrine_rc_style_set_source (MurrineRcStyle       *murrine_rc,
+                             GScanner             *scanner,
+                             guint                 index,
+                             const MurrineOptions *options,
+                             guint64               flags)
+{
+	MurrineRcSource *source;
+
+	if (scanner->input_name == NULL || !g_path_is_absolute (scanner->input_name))
+		return;
+
+	source = g_new0 (MurrineRcSource, 1);
+	source->filename = g_strdup (scanner->input_name);
+	source->index = index;
+	source->flags = flags;
+	theme_options_set_defaults (&source->options);
+	theme_options_copy (&source->options, options, flags);
+
+	murrine_rc_source_free (murrine_rc->source);
+	murrine_rc->source = source;
+
+	murrine_rc_watch_add (source->filename);
+}
+
+static guint
+murrine_rc_style_parse_block (GtkRcStyle  *rc_style,
+                              GtkSettings *settings,
+                              GScanner    *scanner)
+{
+	MurrineRcStyle *murrine_style = MURRINE_RC_STYLE (rc_style);
+	MurrineRcStyle cached;
+	guint64 flags;
+	guint line, position;
+	guint index;
+	guint token;
+
+	line = g_scanner_cur_line (scanner);
+	position = g_scanner_cur_position (scanner);
+
+	/* Blocks are counted per scanner, that is per gtkrc */
+	index = GPOINTER_TO_UINT (g_datalist_get_data (&scanner->qdata, "murrine-rc-blocks"));
+	g_datalist_set_data (&scanner->qdata, "murrine-rc-blocks", GUINT_TO_POINTER (index + 1));
+
+	if (murrine_rc_cache_lookup (scanner, settings, line, position,
+	                             G_STRUCT_MEMBER_P (&cached, RC_OPTIONS_OFFSET), RC_OPTIONS_SIZE,
+	                             RC_OPTIONS_LAYOUT))
+	{
+		theme_options_copy (&murrine_style->options, &cached.options, cached.flags);
+		murrine_style->flags |= cached.flags;
+		murrine_rc_style_set_source (murrine_style, scanner, index, &cached.options, cached.flags);
+
+		return murrine_rc_style_skip_block (scanner);
 	}
 
-	g_scanner_get_next_token(scanner);
+	/* The style may carry options merged from its parent, the cache only
+	 * gets the ones set in this block. */
+	flags = murrine_style->flags;
+	murrine_style->flags = 0;
 
-	g_scanner_set_scope(scanner, old_scope);
+	g_datalist_remove_data (&scanner->qdata, "murrine-rc-symbolic");
+	token = murrine_rc_style_parse_options (rc_style, settings, scanner);
 
-	return G_TOKEN_NONE;
+	if (token == G_TOKEN_NONE)
+	{
+		if (!g_datalist_get_data (&scanner->qdata, "murrine-rc-symbolic"))
+			murrine_rc_cache_store (scanner, settings, line, position,
+			                        G_STRUCT_MEMBER_P (murrine_style, RC_OPTIONS_OFFSET), RC_OPTIONS_SIZE,
+			                        RC_OPTIONS_LAYOUT);
+		murrine_rc_style_set_source (murrine_style, scanner, index,
+		                             &murrine_style->options, murrine_style->flags);
+	}
+
+	murrine_style->flags |= flags;
+
+	return token;
+}
+
+static guint
+murrine_rc_style_parse (GtkRcStyle *rc_style,
+                        GtkSettings  *settings,
+                        GScanner   *scanner)
+{
+	gint64 start = murrine_profile_begin ();
+	guint token;
+
+	token = murrine_rc_style_parse_block (rc_style, settings, scanner);
+
+	murrine_profile_end (MRN_PROFILE_RC_STYLE_PARSE, start);
+
+	return token;
+}
+
+/* Copies the options selected by the flags from src to dest */
+static void
+theme_options_copy (MurrineOptions       *dest,
+                    const MurrineOptions *src,
+                    guint64               flags)
+{
+	guint i;
+
+	for (i = 0; i < MRN_NUM_OPTIONS && (flags >> i) != 0; i++)
+	{
+		const ThemeOption *option = &theme_options[i];
+
+		if (!(flags & MRN_OPTION_FLAG (i)))
+			continue;
+
+		memcpy (G_STRUCT_MEMBER_P (dest, option->offset),
+		        G_STRUCT_MEMBER_P (src, option->offset), option->size);
+		if (option->has_offset != NO_FIELD)
+			G_STRUCT_MEMBER (gboolean, dest, option->has_offset) =
+				G_STRUCT_MEMBER (gboolean, src, option->has_offset);
+	}
+}
+
+/* Returns the flags of the options that are set in only one of a and b,
+ * or set to different values */
+static guint64
+theme_options_diff (const MurrineOptions *a, guint64 a_flags,
+                    const MurrineOptions *b, guint64 b_flags)
+{
+	guint64 flags = a_flags & b_flags;
+	guint64 changed = a_flags ^ b_flags;
+	guint i;
+
+	for (i = 0; i < MRN_NUM_OPTIONS && (flags >> i) != 0; i++)
+	{
+		const ThemeOption *option = &theme_options[i];
+
+		if (!(flags & MRN_OPTION_FLAG (i)))
+			continue;
+
+		if (memcmp (G_STRUCT_MEMBER_P (a, option->offset),
+		            G_STRUCT_MEMBER_P (b, option->offset), option->size) != 0 ||
+		    (option->has_offset != NO_FIELD &&
+		     G_STRUCT_MEMBER (gboolean, a, option->has_offset) !=
+		     G_STRUCT_MEMBER (gboolean, b, option->has_offset)))
+			changed |= MRN_OPTION_FLAG (i);
+	}
+
+	return changed;
 }
 
 static void
@@ -866,9 +995,6 @@ murrine_rc_style_merge (GtkRcStyle *dest,
                         GtkRcStyle *src)
 {
 	MurrineRcStyle *dest_w, *src_w;
-	MurrineRcFlags flags;
-	MurrineRcBasicFlags bflags;
-	MurrineRcGradientFlags gflags;
 
 	GTK_RC_STYLE_CLASS (murrine_rc_style_parent_class)->merge (dest, src);
 
@@ -878,153 +1004,215 @@ murrine_rc_style_merge (GtkRcStyle *dest,
 	src_w = MURRINE_RC_STYLE (src);
 	dest_w = MURRINE_RC_STYLE (dest);
 
-	/* Flags */
-	flags = (~dest_w->flags) & src_w->flags;
+	theme_options_copy (&dest_w->options, &src_w->options, src_w->flags & ~dest_w->flags);
+	dest_w->flags |= src_w->flags;
 
-	if (flags & MRN_FLAG_ARROWSTYLE)
-		dest_w->arrowstyle = src_w->arrowstyle;
-	if (flags & MRN_FLAG_CELLSTYLE)
-		dest_w->cellstyle = src_w->cellstyle;
-	if (flags & MRN_FLAG_COMBOBOXSTYLE)
-		dest_w->comboboxstyle = src_w->comboboxstyle;
-	if (flags & MRN_FLAG_DEFAULT_BUTTON_COLOR)
-	{
-		dest_w->has_default_button_color = src_w->has_default_button_color;
-		dest_w->default_button_color = src_w->default_button_color;
-	}
-	if (src_w->has_treeview_expander_color)
-	{
-		dest_w->has_treeview_expander_color = src_w->has_treeview_expander_color;
-		dest_w->treeview_expander_color = src_w->treeview_expander_color;
-	}
-	if (flags & MRN_FLAG_EXPANDERSTYLE)
-		dest_w->expanderstyle = src_w->expanderstyle;
-	if (flags & MRN_FLAG_FOCUS_COLOR)
+	dest_w->merged = g_slist_append (dest_w->merged, g_object_ref (src_w));
+}
+
+/* Create an empty style suitable to this RC style
+ */
+static GtkStyle *
+murrine_rc_style_create_style (GtkRcStyle *rc_style)
+{
+	return GTK_STYLE (g_object_new (MURRINE_TYPE_STYLE, NULL));
+}
+
+/* The configuration of the gtkrc scanner, without its symbols */
+static const GScannerConfig reload_scanner_config =
+{
+	" \t\r\n",                                 /* cset_skip_characters */
+	"_" G_CSET_a_2_z G_CSET_A_2_Z,             /* cset_identifier_first */
+	G_CSET_DIGITS "-_" G_CSET_a_2_z G_CSET_A_2_Z, /* cset_identifier_nth */
+	"#\n",                                     /* cpair_comment_single */
+	TRUE,                                      /* case_sensitive */
+	TRUE,                                      /* skip_comment_multi */
+	TRUE,                                      /* skip_comment_single */
+	TRUE,                                      /* scan_comment_multi */
+	TRUE,                                      /* scan_identifier */
+	FALSE,                                     /* scan_identifier_1char */
+	FALSE,                                     /* scan_identifier_NULL */
+	TRUE,                                      /* scan_symbols */
+	TRUE,                                      /* scan_binary */
+	TRUE,                                      /* scan_octal */
+	TRUE,                                      /* scan_float */
+	TRUE,                                      /* scan_hex */
+	TRUE,                                      /* scan_hex_dollar */
+	TRUE,                                      /* scan_string_sq */
+	TRUE,                                      /* scan_string_dq */
+	TRUE,                                      /* numbers_2_int */
+	FALSE,                                     /* int_2_float */
+	FALSE,                                     /* identifier_2_string */
+	TRUE,                                      /* char_2_token */
+	TRUE,                                      /* symbol_2_token */
+	FALSE,                                     /* scope_0_fallback */
+};
+
+static MurrineRcStyle *
+murrine_rc_style_find_source (const gchar *filename, guint index)
+{
+	GList *l;
+
+	for (l = rc_styles; l; l = l->next)
 	{
-		dest_w->has_focus_color = src_w->has_focus_color;
-		dest_w->focus_color = src_w->focus_color;
+		MurrineRcSource *source = MURRINE_RC_STYLE (l->data)->source;
+
+		if (source && source->index == index && strcmp (source->filename, filename) == 0)
+			return l->data;
 	}
-	if (flags & MRN_FLAG_FOCUSSTYLE)
-		dest_w->focusstyle = src_w->focusstyle;
-	if (flags & MRN_FLAG_GLAZESTYLE)
-		dest_w->glazestyle = src_w->glazestyle;
-	if (flags & MRN_FLAG_GLOW_SHADE)
-		dest_w->glow_shade = src_w->glow_shade;
-	if (flags & MRN_FLAG_GLOWSTYLE)
-		dest_w->glowstyle = src_w->glowstyle;
-	if (flags & MRN_FLAG_HANDLESTYLE)
-		dest_w->handlestyle = src_w->handlestyle;
-	if (flags & MRN_FLAG_HIGHLIGHT_SHADE)
-		dest_w->highlight_shade = src_w->highlight_shade;
-	if (flags & MRN_FLAG_LIGHTBORDER_SHADE)
-		dest_w->lightborder_shade = src_w->lightborder_shade;
-	if (flags & MRN_FLAG_LIGHTBORDERSTYLE)
-		dest_w->lightborderstyle = src_w->lightborderstyle;
-	if (flags & MRN_FLAG_LISTVIEWHEADERSTYLE)
-		dest_w->listviewheaderstyle = src_w->listviewheaderstyle;
-	if (flags & MRN_FLAG_LISTVIEWSTYLE)
-		dest_w->listviewstyle = src_w->listviewstyle;
-	if (flags & MRN_FLAG_MENUBARITEMSTYLE)
-		dest_w->menubaritemstyle = src_w->menubaritemstyle;
-	if (flags & MRN_FLAG_MENUBARSTYLE)
-		dest_w->menubarstyle = src_w->menubarstyle;
-	if (flags & MRN_FLAG_MENUITEMSTYLE)
-		dest_w->menuitemstyle = src_w->menuitemstyle;
-	if (flags & MRN_FLAG_MENUSTYLE)
-		dest_w->menustyle = src_w->menustyle;
-	if (flags & MRN_FLAG_PRELIGHT_SHADE)
-		dest_w->prelight_shade = src_w->prelight_shade;
-	if (flags & MRN_FLAG_PROGRESSBARSTYLE)
-		dest_w->progressbarstyle = src_w->progressbarstyle;
-	if (flags & MRN_FLAG_RELIEFSTYLE)
-		dest_w->reliefstyle = src_w->reliefstyle;
-	if (flags & MRN_FLAG_SCROLLBARSTYLE)
-		dest_w->scrollbarstyle = src_w->scrollbarstyle;
-	if (flags & MRN_FLAG_SEPARATORSTYLE)
-		dest_w->separatorstyle = src_w->separatorstyle;
-	if (flags & MRN_FLAG_SLIDERSTYLE)
-		dest_w->sliderstyle = src_w->sliderstyle;
-	if (flags & MRN_FLAG_SPINBUTTONSTYLE)
-		dest_w->spinbuttonstyle = src_w->spinbuttonstyle;
-	if (flags & MRN_FLAG_STEPPERSTYLE)
-		dest_w->stepperstyle = src_w->stepperstyle;
-	if (flags & MRN_FLAG_TEXTSTYLE)
-		dest_w->textstyle = src_w->textstyle;
-	if (flags & MRN_FLAG_TEXT_SHADE)
-		dest_w->text_shade = src_w->text_shade;
-	if (flags & MRN_FLAG_TOOLBARSTYLE)
-		dest_w->toolbarstyle = src_w->toolbarstyle;
 
-	dest_w->flags |= src_w->flags;
+	return NULL;
+}
 
-	/* Basic Flags */
-	bflags = (~dest_w->bflags) & src_w->bflags;
+/* Parses a block again into the source of the style it was parsed into.
+ * The style itself is left alone until all of them are resolved. */
+static guint
+murrine_rc_style_reparse (MurrineRcStyle *murrine_rc,
+                          GScanner       *scanner,
+                          gboolean       *changed)
+{
+	MurrineRcSource *source = murrine_rc->source;
+	MurrineOptions options;
+	guint64 flags;
+	guint token;
 
-	if (bflags & MRN_FLAG_ANIMATION)
-		dest_w->animation = src_w->animation;
-	if (bflags & MRN_FLAG_COLORIZE_SCROLLBAR)
-		dest_w->colorize_scrollbar = src_w->colorize_scrollbar;
-	if (bflags & MRN_FLAG_CONTRAST)
-		dest_w->contrast = src_w->contrast;
-	if (bflags & MRN_FLAG_RGBA)
-		dest_w->rgba = src_w->rgba;
-	if (bflags & MRN_FLAG_ROUNDNESS)
-		dest_w->roundness = src_w->roundness;
+	/* Parsing into the style itself resolves symbolic colors like
+	 * the first time */
+	memcpy (&options, &murrine_rc->options, sizeof (MurrineOptions));
+	flags = murrine_rc->flags;
 
-	dest_w->bflags |= src_w->bflags;
+	theme_options_set_defaults (&murrine_rc->options);
+	murrine_rc->flags = 0;
 
-	/* Gradient Flags */
-	gflags = (~dest_w->gflags) & src_w->gflags;
+	token = murrine_rc_style_parse_options (GTK_RC_STYLE (murrine_rc),
+	                                        gtk_settings_get_default (), scanner);
 
-	if (gflags & MRN_FLAG_BORDER_COLORS)
-	{
-		dest_w->has_border_colors = src_w->has_border_colors;
-		dest_w->border_colors[0]  = src_w->border_colors[0];
-		dest_w->border_colors[1]  = src_w->border_colors[1];
-	}
-	if (gflags & MRN_FLAG_BORDER_SHADES)
+	if (token == G_TOKEN_NONE &&
+	    theme_options_diff (&source->options, source->flags,
+	                        &murrine_rc->options, murrine_rc->flags) != 0)
 	{
-		dest_w->border_shades[0] = src_w->border_shades[0];
-		dest_w->border_shades[1] = src_w->border_shades[1];
+		memcpy (&source->options, &murrine_rc->options, sizeof (MurrineOptions));
+		source->flags = murrine_rc->flags;
+		*changed = TRUE;
 	}
-	if (gflags & MRN_FLAG_GRADIENT_COLORS)
-	{
-		dest_w->has_gradient_colors = src_w->has_gradient_colors;
-		dest_w->gradient_colors[0]  = src_w->gradient_colors[0];
-		dest_w->gradient_colors[1]  = src_w->gradient_colors[1];
-		dest_w->gradient_colors[2]  = src_w->gradient_colors[2];
-		dest_w->gradient_colors[3]  = src_w->gradient_colors[3];
-	}
-	if (gflags & MRN_FLAG_GRADIENT_SHADES)
+
+	memcpy (&murrine_rc->options, &options, sizeof (MurrineOptions));
+	murrine_rc->flags = flags;
+
+	return token;
+}
+
+static gboolean
+murrine_rc_style_reload_file (const gchar *filename)
+{
+	GScanner *scanner;
+	gchar *contents;
+	gsize length;
+	gboolean changed = FALSE;
+	guint index = 0;
+	guint token;
+
+	if (!g_file_get_contents (filename, &contents, &length, NULL))
+		return FALSE;
+
+	scanner = g_scanner_new (&reload_scanner_config);
+	scanner->input_name = filename;
+	g_scanner_input_text (scanner, contents, length);
+
+	while ((token = g_scanner_get_next_token (scanner)) != G_TOKEN_EOF)
 	{
-		dest_w->gradient_shades[0] = src_w->gradient_shades[0];
-		dest_w->gradient_shades[1] = src_w->gradient_shades[1];
-		dest_w->gradient_shades[2] = src_w->gradient_shades[2];
-		dest_w->gradient_shades[3] = src_w->gradient_shades[3];
+		MurrineRcStyle *murrine_rc;
+
+		if (!theme_token_is (scanner, token, "engine") ||
+		    g_scanner_get_next_token (scanner) != G_TOKEN_STRING ||
+		    strcmp (scanner->value.v_string, "xamarin") != 0 ||
+		    g_scanner_get_next_token (scanner) != G_TOKEN_LEFT_CURLY)
+			continue;
+
+		murrine_rc = murrine_rc_style_find_source (filename, index++);
+		if (murrine_rc)
+			token = murrine_rc_style_reparse (murrine_rc, scanner, &changed);
+		else
+			token = murrine_rc_style_skip_block (scanner);
+
+		/* the file may be saved halfway through an edit, what came
+		 * before the error is kept */
+		if (token != G_TOKEN_NONE)
+		{
+			g_scanner_unexp_token (scanner, token, NULL, NULL, NULL, NULL, FALSE);
+			break;
+		}
 	}
-	if (gflags & MRN_FLAG_SHADOW_SHADES)
+
+	g_scanner_destroy (scanner);
+	g_free (contents);
+
+	return changed;
+}
+
+/* Options of a style come from its own block first, then from the
+ * styles merged into it, as in murrine_rc_style_merge () */
+static void
+murrine_rc_style_resolve (MurrineRcStyle *murrine_rc)
+{
+	GSList *l;
+
+	theme_options_set_defaults (&murrine_rc->options);
+	murrine_rc->flags = 0;
+
+	if (murrine_rc->source)
 	{
-		dest_w->shadow_shades[0] = src_w->shadow_shades[0];
-		dest_w->shadow_shades[1] = src_w->shadow_shades[1];
+		theme_options_copy (&murrine_rc->options, &murrine_rc->source->options,
+		                    murrine_rc->source->flags);
+		murrine_rc->flags = murrine_rc->source->flags;
 	}
-	if (gflags & MRN_FLAG_TROUGH_BORDER_SHADES)
+
+	for (l = murrine_rc->merged; l; l = l->next)
 	{
-		dest_w->trough_border_shades[0] = src_w->trough_border_shades[0];
-		dest_w->trough_border_shades[1] = src_w->trough_border_shades[1];
+		MurrineRcStyle *src_w = l->data;
+
+		theme_options_copy (&murrine_rc->options, &src_w->options,
+		                    src_w->flags & ~murrine_rc->flags);
+		murrine_rc->flags |= src_w->flags;
 	}
-	if (gflags & MRN_FLAG_TROUGH_SHADES)
+}
+
+/* Reads the engine blocks of the gtkrc files again and updates the
+ * options of the styles, without going through gtk_rc_reparse_all ().
+ * Only the styles whose options changed drop their palette and caches.
+ * Returns TRUE if anything changed. */
+gboolean
+murrine_rc_style_reload (void)
+{
+	GHashTable *files;
+	GHashTableIter iter;
+	gpointer filename;
+	gboolean changed = FALSE;
+	GList *l;
+
+	files = g_hash_table_new (g_str_hash, g_str_equal);
+	for (l = rc_styles; l; l = l->next)
 	{
-		dest_w->trough_shades[0] = src_w->trough_shades[0];
-		dest_w->trough_shades[1] = src_w->trough_shades[1];
+		MurrineRcSource *source = MURRINE_RC_STYLE (l->data)->source;
+
+		if (source)
+			g_hash_table_insert (files, source->filename, NULL);
 	}
 
-	dest_w->gflags |= src_w->gflags;
-}
+	g_hash_table_iter_init (&iter, files);
+	while (g_hash_table_iter_next (&iter, &filename, NULL))
+		changed |= murrine_rc_style_reload_file (filename);
 
-/* Create an empty style suitable to this RC style
- */
-static GtkStyle *
-murrine_rc_style_create_style (GtkRcStyle *rc_style)
-{
-	return GTK_STYLE (g_object_new (MURRINE_TYPE_STYLE, NULL));
+	g_hash_table_destroy (files);
+
+	if (!changed)
+		return FALSE;
+
+	/* merged styles come after the styles they are made of */
+	for (l = g_list_last (rc_styles); l; l = l->prev)
+		murrine_rc_style_resolve (l->data);
+
+	murrine_style_reload ();
+
+	return TRUE;
 }
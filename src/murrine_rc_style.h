@@ -20,6 +20,8 @@
 
 #include <gtk/gtkrc.h>
 
+#include "murrine_types.h"
+
 #ifndef MURRINE_RC_STYLE_H
 #define MURRINE_RC_STYLE_H
 
@@ -35,123 +37,73 @@ typedef struct _MurrineRcStyleClass XamarinRcStyleClass;
 #define MURRINE_IS_RC_STYLE_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), MURRINE_TYPE_RC_STYLE))
 #define MURRINE_RC_STYLE_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), MURRINE_TYPE_RC_STYLE, MurrineRcStyleClass))
 
+/* One per option, in the order of the option table */
 typedef enum
 {
-//	MRN_FLAG_UNUSED = 1 << 0,
-	MRN_FLAG_ARROWSTYLE = 1 << 1,
-	MRN_FLAG_CELLSTYLE = 1 << 2,
-	MRN_FLAG_COMBOBOXSTYLE = 1 << 3,
-	MRN_FLAG_DEFAULT_BUTTON_COLOR = 1 << 4,
-	MRN_FLAG_FOCUS_COLOR = 1 << 5,
-	MRN_FLAG_FOCUSSTYLE = 1 << 6,
-	MRN_FLAG_EXPANDERSTYLE = 1 << 7,
-	MRN_FLAG_GLAZESTYLE = 1 << 8,
-	MRN_FLAG_GLOW_SHADE = 1 << 9,
-	MRN_FLAG_GLOWSTYLE = 1 << 10,
-	MRN_FLAG_HANDLESTYLE = 1 << 11,
-	MRN_FLAG_HIGHLIGHT_SHADE = 1 << 12,
-	MRN_FLAG_LIGHTBORDER_SHADE = 1 << 13,
-	MRN_FLAG_LIGHTBORDERSTYLE= 1 << 14,
-	MRN_FLAG_LISTVIEWHEADERSTYLE = 1 << 15,
-	MRN_FLAG_LISTVIEWSTYLE = 1 << 16,
-	MRN_FLAG_MENUBARITEMSTYLE = 1 << 17,
-	MRN_FLAG_MENUBARSTYLE = 1 << 18,
-	MRN_FLAG_MENUITEMSTYLE = 1 << 19,
-	MRN_FLAG_MENUSTYLE = 1 << 20,
-	MRN_FLAG_PRELIGHT_SHADE = 1 << 21,
-	MRN_FLAG_PROGRESSBARSTYLE = 1 << 22,
-	MRN_FLAG_RELIEFSTYLE = 1 << 23,
-	MRN_FLAG_SCROLLBARSTYLE = 1 << 24,
-	MRN_FLAG_SEPARATORSTYLE = 1 << 25,
-	MRN_FLAG_SLIDERSTYLE = 1 << 26,
-	MRN_FLAG_SPINBUTTONSTYLE = 1 << 27,
-	MRN_FLAG_STEPPERSTYLE = 1 << 28,
-	MRN_FLAG_TEXTSTYLE = 1 << 29,
-	MRN_FLAG_TEXT_SHADE = 1 << 30,
-	MRN_FLAG_TOOLBARSTYLE = 1 << 31
-} MurrineRcFlags;
-
-typedef enum
-{
-	MRN_FLAG_ANIMATION = 1 << 0,
-	MRN_FLAG_COLORIZE_SCROLLBAR = 1 << 1,
-	MRN_FLAG_CONTRAST = 1 << 2,
-	MRN_FLAG_RGBA = 1 << 3,
-	MRN_FLAG_ROUNDNESS = 1 << 4
-} MurrineRcBasicFlags;
-
-typedef enum
-{
-//	MRN_FLAG_UNUSED = 1 << 0,
-	MRN_FLAG_BORDER_COLORS = 1 << 1,
-	MRN_FLAG_BORDER_SHADES = 1 << 2,
-	MRN_FLAG_GRADIENT_COLORS = 1 << 3,
-	MRN_FLAG_GRADIENT_SHADES = 1 << 4,
-	MRN_FLAG_SHADOW_SHADES = 1 << 5,
-	MRN_FLAG_TROUGH_BORDER_SHADES = 1 << 6,
-	MRN_FLAG_TROUGH_SHADES = 1 << 7
-} MurrineRcGradientFlags;
+	MRN_OPTION_ANIMATION,
+	MRN_OPTION_ARROWSTYLE,
+	MRN_OPTION_BORDER_COLORS,
+	MRN_OPTION_BORDER_SHADES,
+	MRN_OPTION_CELLSTYLE,
+	MRN_OPTION_COLORIZE_SCROLLBAR,
+	MRN_OPTION_COMBOBOXSTYLE,
+	MRN_OPTION_CONTRAST,
+	MRN_OPTION_DEFAULT_BUTTON_COLOR,
+	MRN_OPTION_EXPANDERSTYLE,
+	MRN_OPTION_FOCUS_COLOR,
+	MRN_OPTION_FOCUSSTYLE,
+	MRN_OPTION_GLAZESTYLE,
+	MRN_OPTION_GLOW_SHADE,
+	MRN_OPTION_GLOWSTYLE,
+	MRN_OPTION_GRADIENT_COLORS,
+	MRN_OPTION_GRADIENT_SHADES,
+	MRN_OPTION_HANDLESTYLE,
+	MRN_OPTION_HIGHLIGHT_SHADE,
+	MRN_OPTION_LIGHTBORDER_SHADE,
+	MRN_OPTION_LIGHTBORDERSTYLE,
+	MRN_OPTION_LISTVIEWHEADERSTYLE,
+	MRN_OPTION_LISTVIEWSTYLE,
+	MRN_OPTION_MENUBARITEMSTYLE,
+	MRN_OPTION_MENUBARSTYLE,
+	MRN_OPTION_MENUITEMSTYLE,
+	MRN_OPTION_MENUSTYLE,
+	MRN_OPTION_PRELIGHT_SHADE,
+	MRN_OPTION_PROGRESSBARSTYLE,
+	MRN_OPTION_RELIEFSTYLE,
+	MRN_OPTION_RGBA,
+	MRN_OPTION_ROUNDNESS,
+	MRN_OPTION_SCROLLBARSTYLE,
+	MRN_OPTION_SEPARATORSTYLE,
+	MRN_OPTION_SHADOW_SHADES,
+	MRN_OPTION_SLIDERSTYLE,
+	MRN_OPTION_SPINBUTTONSTYLE,
+	MRN_OPTION_STEPPERSTYLE,
+	MRN_OPTION_TEXTSTYLE,
+	MRN_OPTION_TEXT_SHADE,
+	MRN_OPTION_TOOLBARSTYLE,
+	MRN_OPTION_TRANSITION_DURATIONS,
+	MRN_OPTION_TREEVIEW_EXPANDER_COLOR,
+	MRN_OPTION_TROUGH_BORDER_SHADES,
+	MRN_OPTION_TROUGH_SHADES,
+	MRN_NUM_OPTIONS
+} MurrineOptionId;
+
+#define MRN_OPTION_FLAG(id) (G_GUINT64_CONSTANT (1) << (id))
+
+typedef struct _MurrineRcSource MurrineRcSource;
 
 struct _MurrineRcStyle
 {
 	GtkRcStyle parent_instance;
 
-	MurrineRcFlags flags;
-	MurrineRcBasicFlags bflags;
-	MurrineRcGradientFlags gflags;
-
-	double   border_shades[2];
-	double   contrast;
-	double   glow_shade;
-	double   gradient_shades[4];
-	double   highlight_shade;
-	double   lightborder_shade;
-	double   prelight_shade;
-	double   shadow_shades[2];
-	double   text_shade;
-	double   trough_border_shades[2];
-	double   trough_shades[2];
-
-	guint8   arrowstyle;
-	guint8   cellstyle;
-	guint8   comboboxstyle;
-	guint8   expanderstyle;
-	guint8   focusstyle;
-	guint8   glazestyle;
-	guint8   glowstyle;
-	guint8   handlestyle;
-	guint8   lightborderstyle;
-	guint8   listviewheaderstyle;
-	guint8   listviewstyle;
-	guint8   menubaritemstyle;
-	guint8   menubarstyle;
-	guint8   menuitemstyle;
-	guint8   menustyle;
-	guint8   progressbarstyle;
-	guint8   reliefstyle;
-	guint8   roundness;
-	guint8   scrollbarstyle;
-	guint8   separatorstyle;
-	guint8   sliderstyle;
-	guint8   spinbuttonstyle;
-	guint8   stepperstyle;
-	guint8   textstyle;
-	guint8   toolbarstyle;
-
-	gboolean animation;
-	gboolean colorize_scrollbar;
-	gboolean has_border_colors;
-	gboolean has_treeview_expander_color;
-	gboolean has_default_button_color;
-	gboolean has_focus_color;
-	gboolean has_gradient_colors;
-	gboolean rgba;
-
-	GdkColor border_colors[2];
-	GdkColor default_button_color;
-	GdkColor focus_color;
-	GdkColor gradient_colors[4];
-	GdkColor treeview_expander_color;
+	/* Where the options come from, to reload them: the engine block
+	 * parsed into this style and the styles merged into it, in order */
+	MurrineRcSource *source;
+	GSList          *merged;
+
+	guint64 flags; /* MRN_OPTION_FLAG of every option set */
+
+	MurrineOptions options;
 };
 
 struct _MurrineRcStyleClass
@@ -161,4 +113,6 @@ struct _MurrineRcStyleClass
 
 GType murrine_rc_style_get_type	(void);
 
+G_GNUC_INTERNAL gboolean murrine_rc_style_reload (void);
+
 #endif /* MURRINE_RC_STYLE_H */
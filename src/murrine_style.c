@@ -29,6 +29,9 @@
 #include "murrine_draw.h"
 #include "support.h"
 #include "cairo-support.h"
+#include "draw-profile.h"
+#include "profile.h"
+#include "trace.h"
 
 /* #define DEBUG 1 */
 
@@ -72,6 +75,9 @@
 
 G_DEFINE_DYNAMIC_TYPE (XamarinStyle, murrine_style, GTK_TYPE_STYLE)
 
+/* Every MurrineStyle, for murrine_style_reload () */
+static GSList *styles = NULL;
+
 static cairo_t *
 murrine_begin_paint (GdkDrawable *window, GdkRectangle *area)
 {
@@ -82,6 +88,10 @@ murrine_begin_paint (GdkDrawable *window, GdkRectangle *area)
 	cr = (cairo_t*) gdk_cairo_create (window);
 	cairo_set_line_width (cr, 1.0);
 
+#ifdef HAVE_ANIMATION
+	murrine_animation_track_paint (cr);
+#endif
+
 	if (area)
 	{
 		cairo_rectangle (cr, area->x, area->y, area->width, area->height);
@@ -117,6 +127,24 @@ boolean murrine_widget_is_rgba (GtkWidget *widget)
 	return use_rgba;
 }
 
+/* Returns the palette shared by the styles with the same options and
+ * colors, looking it up on first use. */
+static MurrinePalette *
+murrine_style_get_palette (MurrineStyle *murrine_style)
+{
+	if (!murrine_style->palette)
+		murrine_style->palette = murrine_palette_lookup (&murrine_style->options,
+		                                                 GTK_STYLE (murrine_style));
+
+	return murrine_style->palette;
+}
+
+static MurrineColors *
+murrine_style_get_colors (MurrineStyle *murrine_style)
+{
+	return murrine_palette_get_colors (murrine_style_get_palette (murrine_style));
+}
+
 static void
 murrine_set_widget_parameters (const GtkWidget  *widget,
                                const GtkStyle   *style,
@@ -131,95 +159,95 @@ murrine_set_widget_parameters (const GtkWidget  *widget,
 	params->state_type = (MurrineStateType)state_type;
 	params->corners    = MRN_CORNER_ALL;
 	params->ltr        = murrine_widget_is_ltr ((GtkWidget*)widget);
-	params->focus      = (MURRINE_STYLE (style)->focusstyle != 0) && widget && GTK_WIDGET_HAS_FOCUS (widget);
+	params->focus      = (MURRINE_STYLE (style)->options.focusstyle != 0) && widget && GTK_WIDGET_HAS_FOCUS (widget);
 	params->is_default = widget && GTK_WIDGET_HAS_DEFAULT (widget);
 
 	params->xthickness = style->xthickness;
 	params->ythickness = style->ythickness;
 
-	params->contrast          = murrine_style->contrast;
-	params->glazestyle        = murrine_style->glazestyle;
-	params->glow_shade        = murrine_style->glow_shade;
-	params->glowstyle         = murrine_style->glowstyle;
-	params->highlight_shade   = murrine_style->highlight_shade;
-	params->lightborder_shade = murrine_style->lightborder_shade;
-	params->lightborderstyle  = murrine_style->lightborderstyle;
-	params->reliefstyle       = murrine_style->reliefstyle;
-	params->roundness         = murrine_style->roundness;
+	params->contrast          = murrine_style->options.contrast;
+	params->glazestyle        = murrine_style->options.glazestyle;
+	params->glow_shade        = murrine_style->options.glow_shade;
+	params->glowstyle         = murrine_style->options.glowstyle;
+	params->highlight_shade   = murrine_style->options.highlight_shade;
+	params->lightborder_shade = murrine_style->options.lightborder_shade;
+	params->lightborderstyle  = murrine_style->options.lightborderstyle;
+	params->reliefstyle       = murrine_style->options.reliefstyle;
+	params->roundness         = murrine_style->options.roundness;
 
 	MurrineGradients mrn_gradient;
-	mrn_gradient.border_shades[0] = murrine_style->border_shades[0];
-	mrn_gradient.border_shades[1] = murrine_style->border_shades[1];
+	mrn_gradient.border_shades[0] = murrine_style->options.border_shades[0];
+	mrn_gradient.border_shades[1] = murrine_style->options.border_shades[1];
 
-	mrn_gradient.gradient_shades[0] = murrine_style->gradient_shades[0];
-	mrn_gradient.gradient_shades[1] = murrine_style->gradient_shades[1];
-	mrn_gradient.gradient_shades[2] = murrine_style->gradient_shades[2];
-	mrn_gradient.gradient_shades[3] = murrine_style->gradient_shades[3];
+	mrn_gradient.gradient_shades[0] = murrine_style->options.gradient_shades[0];
+	mrn_gradient.gradient_shades[1] = murrine_style->options.gradient_shades[1];
+	mrn_gradient.gradient_shades[2] = murrine_style->options.gradient_shades[2];
+	mrn_gradient.gradient_shades[3] = murrine_style->options.gradient_shades[3];
 
-	if (murrine_style->has_gradient_colors && !params->disabled)
+	if (murrine_style->options.has_gradient_colors && !params->disabled)
 	{
 		mrn_gradient.has_gradient_colors = TRUE;
-		murrine_gdk_color_to_rgb (&murrine_style->gradient_colors[0], &mrn_gradient.gradient_colors[0].r,
+		murrine_gdk_color_to_rgb (&murrine_style->options.gradient_colors[0], &mrn_gradient.gradient_colors[0].r,
 		                                                              &mrn_gradient.gradient_colors[0].g,
 		                                                              &mrn_gradient.gradient_colors[0].b);
-		murrine_gdk_color_to_rgb (&murrine_style->gradient_colors[1], &mrn_gradient.gradient_colors[1].r,
+		murrine_gdk_color_to_rgb (&murrine_style->options.gradient_colors[1], &mrn_gradient.gradient_colors[1].r,
 		                                                              &mrn_gradient.gradient_colors[1].g,
 		                                                              &mrn_gradient.gradient_colors[1].b);
-		murrine_gdk_color_to_rgb (&murrine_style->gradient_colors[2], &mrn_gradient.gradient_colors[2].r,
+		murrine_gdk_color_to_rgb (&murrine_style->options.gradient_colors[2], &mrn_gradient.gradient_colors[2].r,
 		                                                              &mrn_gradient.gradient_colors[2].g,
 		                                                              &mrn_gradient.gradient_colors[2].b);
-		murrine_gdk_color_to_rgb (&murrine_style->gradient_colors[3], &mrn_gradient.gradient_colors[3].r,
+		murrine_gdk_color_to_rgb (&murrine_style->options.gradient_colors[3], &mrn_gradient.gradient_colors[3].r,
 		                                                              &mrn_gradient.gradient_colors[3].g,
 		                                                              &mrn_gradient.gradient_colors[3].b);
 		if (params->prelight && !MRN_IS_PROGRESS_BAR(widget)) //progressbar is prelight, no change in shade
 		{
-			mrn_gradient.gradient_shades[0] *= murrine_style->prelight_shade;
-			mrn_gradient.gradient_shades[1] *= murrine_style->prelight_shade;
-			mrn_gradient.gradient_shades[2] *= murrine_style->prelight_shade;
-			mrn_gradient.gradient_shades[3] *= murrine_style->prelight_shade;
+			mrn_gradient.gradient_shades[0] *= murrine_style->options.prelight_shade;
+			mrn_gradient.gradient_shades[1] *= murrine_style->options.prelight_shade;
+			mrn_gradient.gradient_shades[2] *= murrine_style->options.prelight_shade;
+			mrn_gradient.gradient_shades[3] *= murrine_style->options.prelight_shade;
 		}
 	}
 	else
 		mrn_gradient.has_gradient_colors = FALSE;
 
-	if (murrine_style->has_border_colors && !params->disabled)
+	if (murrine_style->options.has_border_colors && !params->disabled)
 	{
 		mrn_gradient.has_border_colors = TRUE;
-		murrine_gdk_color_to_rgb (&murrine_style->border_colors[0], &mrn_gradient.border_colors[0].r,
+		murrine_gdk_color_to_rgb (&murrine_style->options.border_colors[0], &mrn_gradient.border_colors[0].r,
 	                                                                    &mrn_gradient.border_colors[0].g,
 	                                                                    &mrn_gradient.border_colors[0].b);
-		murrine_gdk_color_to_rgb (&murrine_style->border_colors[1], &mrn_gradient.border_colors[1].r,
+		murrine_gdk_color_to_rgb (&murrine_style->options.border_colors[1], &mrn_gradient.border_colors[1].r,
 	                                                                    &mrn_gradient.border_colors[1].g,
 	                                                                    &mrn_gradient.border_colors[1].b);
 	}
 	else
 		mrn_gradient.has_border_colors = FALSE;
 
-	mrn_gradient.shadow_shades[0] = murrine_style->shadow_shades[0];
-	mrn_gradient.shadow_shades[1] = murrine_style->shadow_shades[1];
-	mrn_gradient.trough_border_shades[0] = murrine_style->trough_border_shades[0];
-	mrn_gradient.trough_border_shades[1] = murrine_style->trough_border_shades[1];
-	mrn_gradient.trough_shades[0] = murrine_style->trough_shades[0];
-	mrn_gradient.trough_shades[1] = murrine_style->trough_shades[1];
-
-	if (murrine_style->border_shades[0] != 1.0 ||
-	    murrine_style->border_shades[1] != 1.0 ||
-	    murrine_style->gradient_shades[0] != 1.0 ||
-	    murrine_style->gradient_shades[1] != 1.0 ||
-	    murrine_style->gradient_shades[2] != 1.0 ||
-	    murrine_style->gradient_shades[3] != 1.0 ||
-	    murrine_style->shadow_shades[0] != 1.0 ||
-	    murrine_style->shadow_shades[1] != 1.0 ||
-	    murrine_style->trough_border_shades[0] != 1.0 ||
-	    murrine_style->trough_border_shades[1] != 1.0 ||
-	    murrine_style->trough_shades[0] != 1.0 ||
-	    murrine_style->trough_shades[1] != 1.0)
+	mrn_gradient.shadow_shades[0] = murrine_style->options.shadow_shades[0];
+	mrn_gradient.shadow_shades[1] = murrine_style->options.shadow_shades[1];
+	mrn_gradient.trough_border_shades[0] = murrine_style->options.trough_border_shades[0];
+	mrn_gradient.trough_border_shades[1] = murrine_style->options.trough_border_shades[1];
+	mrn_gradient.trough_shades[0] = murrine_style->options.trough_shades[0];
+	mrn_gradient.trough_shades[1] = murrine_style->options.trough_shades[1];
+
+	if (murrine_style->options.border_shades[0] != 1.0 ||
+	    murrine_style->options.border_shades[1] != 1.0 ||
+	    murrine_style->options.gradient_shades[0] != 1.0 ||
+	    murrine_style->options.gradient_shades[1] != 1.0 ||
+	    murrine_style->options.gradient_shades[2] != 1.0 ||
+	    murrine_style->options.gradient_shades[3] != 1.0 ||
+	    murrine_style->options.shadow_shades[0] != 1.0 ||
+	    murrine_style->options.shadow_shades[1] != 1.0 ||
+	    murrine_style->options.trough_border_shades[0] != 1.0 ||
+	    murrine_style->options.trough_border_shades[1] != 1.0 ||
+	    murrine_style->options.trough_shades[0] != 1.0 ||
+	    murrine_style->options.trough_shades[1] != 1.0)
 		mrn_gradient.gradients = TRUE;
 	else
 		mrn_gradient.gradients = FALSE;
 
 	mrn_gradient.use_rgba = (murrine_widget_is_rgba ((GtkWidget*) widget) &&
-	                         murrine_style->rgba);
+	                         murrine_style->options.rgba);
 	mrn_gradient.rgba_opacity = GRADIENT_OPACITY;
 
 	MurrineStyles mrn_style = MRN_STYLE_MURRINE;
@@ -232,10 +260,238 @@ murrine_set_widget_parameters (const GtkWidget  *widget,
 
 	/* I want to avoid to have to do this. I need it for GtkEntry, unless I
 	   find out why it doesn't behave the way I expect it to. */
-	params->parentbg = MURRINE_STYLE (style)->colors.bg[state_type];
+	params->parentbg = murrine_style_get_colors (MURRINE_STYLE (style))->bg[state_type];
 	murrine_get_parent_bg (widget, &params->parentbg);
 }
 
+/* Tree view rows are horizontally invariant, so a single column of pixels is
+ * rendered once per row height and repeated across the row while scrolling. */
+#define ROW_STRIPE_MAX_HEIGHT  0xffff
+#define ROW_STRIPE_MAX_ENTRIES 64
+
+typedef enum
+{
+	MRN_ROW_STRIPE_SELECTED_CELL,
+	MRN_ROW_STRIPE_LISTVIEW
+} MurrineRowStripeType;
+
+
+/* Returns a pattern to be painted at the row origin, or NULL if the row
+ * can not be cached. The pattern is owned by the style. */
+static cairo_pattern_t *
+murrine_style_get_row_stripe (MurrineStyle           *murrine_style,
+                              MurrineRowStripeType    type,
+                              const WidgetParameters *params,
+                              const CellParameters   *cell,
+                              boolean                 odd,
+                              int                     height)
+{
+	MurrinePalette *palette;
+	cairo_pattern_t *pattern;
+	guint key;
+
+	if (height <= 0 || height > ROW_STRIPE_MAX_HEIGHT)
+		return NULL;
+
+	key = height |
+	      (murrine_style->options.cellstyle & 0xf) << 21 |
+	      (murrine_style->options.listviewstyle & 0xf) << 25 |
+	      (odd ? 1 : 0) << 29 |
+	      (type & 0x1) << 30;
+
+	/* The listview decoration only depends on the height and text color */
+	if (params)
+		key |= (params->state_type & 0x7) << 16 |
+		       (params->focus ? 1 : 0) << 19 |
+		       (params->style & 0x1) << 20;
+
+	palette = murrine_style_get_palette (murrine_style);
+	if (palette->row_stripes == NULL)
+		palette->row_stripes = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+		                                              NULL, (GDestroyNotify) cairo_pattern_destroy);
+
+	pattern = g_hash_table_lookup (palette->row_stripes, GUINT_TO_POINTER (key));
+
+	if (pattern == NULL)
+	{
+		cairo_surface_t *surface;
+		cairo_t *cr;
+
+		MRN_TRACE_CACHE_MISS ("row-stripe", 1, height);
+
+		/* Row heights are bounded in practice, this only guards against
+		 * pathological widgets growing the table forever. */
+		if (g_hash_table_size (palette->row_stripes) >= ROW_STRIPE_MAX_ENTRIES)
+			g_hash_table_remove_all (palette->row_stripes);
+
+		surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, height);
+		cr = cairo_create (surface);
+		cairo_set_line_width (cr, 1.0);
+
+		if (type == MRN_ROW_STRIPE_SELECTED_CELL)
+		{
+			params->style_functions->draw_selected_cell (cr, murrine_style_get_colors (murrine_style), params, cell,
+			                                             0, 0, 1, height);
+		}
+		else
+		{
+			int i;
+
+			murrine_set_color_rgba (cr, &murrine_style_get_colors (murrine_style)->text[GTK_STATE_NORMAL], 0.42);
+			for (i = 2; i < height; i+=4)
+				cairo_rectangle (cr, 0, i, 1, 1);
+			cairo_fill (cr);
+		}
+
+		cairo_destroy (cr);
+
+		pattern = cairo_pattern_create_for_surface (surface);
+		cairo_surface_destroy (surface);
+
+		if (type == MRN_ROW_STRIPE_SELECTED_CELL)
+			cairo_pattern_set_extend (pattern, CAIRO_EXTEND_REPEAT);
+
+		g_hash_table_insert (palette->row_stripes, GUINT_TO_POINTER (key), pattern);
+
+		MRN_TRACE_CACHE_FILL ("row-stripe");
+	}
+
+	return pattern;
+}
+
+static void
+murrine_style_clear_caches (MurrineStyle *murrine_style)
+{
+	if (murrine_style->palette)
+	{
+		murrine_palette_unref (murrine_style->palette);
+		murrine_style->palette = NULL;
+	}
+}
+
+static void
+murrine_style_draw_button_list (MurrineStyle           *murrine_style,
+                                cairo_t                *cr,
+                                const WidgetParameters *params,
+                                const ButtonParameters *button,
+                                int x, int y, int width, int height,
+                                boolean horizontal)
+{
+	MurrinePalette *palette = murrine_style_get_palette (murrine_style);
+	MurrineDisplayListKey key;
+	cairo_t *draw_cr;
+
+	if (!palette->display_lists)
+		palette->display_lists = murrine_display_lists_new ();
+
+	murrine_display_list_key_button (&key, params, button, width, height, horizontal);
+
+	draw_cr = murrine_display_list_begin (palette->display_lists, cr, &key, &x, &y);
+	if (draw_cr)
+	{
+		params->style_functions->draw_button (draw_cr, murrine_style_get_colors (murrine_style), params, button,
+		                                      x, y, width, height, horizontal);
+		murrine_display_list_end (palette->display_lists, cr, draw_cr);
+	}
+}
+
+#ifdef HAVE_ANIMATION
+/* Draws a button part way between states. The fill, and the border
+ * shaded from it, blend the precomputed colors of the states, while the
+ * state flags of the widget pick the shape. Blends are not recorded in
+ * the display lists, which are keyed by state. */
+static void
+murrine_style_draw_button_blended (MurrineStyle           *murrine_style,
+                                   cairo_t                *cr,
+                                   const WidgetParameters *params,
+                                   const ButtonParameters *button,
+                                   double prelight, double active,
+                                   int x, int y, int width, int height,
+                                   boolean horizontal)
+{
+	MurrineColors colors = *murrine_style_get_colors (murrine_style);
+	WidgetParameters blended = *params;
+	MurrineRGB fill;
+	int i;
+
+	murrine_mix_color (&colors.bg[GTK_STATE_NORMAL], &colors.bg[GTK_STATE_PRELIGHT], prelight, &fill);
+	murrine_mix_color (&fill, &colors.bg[GTK_STATE_ACTIVE], active, &colors.bg[params->state_type]);
+
+	/* murrine_set_widget_parameters () brightens prelit gradient colors */
+	if (blended.mrn_gradient.has_gradient_colors)
+		for (i = 0; i < 4; i++)
+			blended.mrn_gradient.gradient_shades[i] = murrine_style->options.gradient_shades[i] *
+			                                          (1.0 + prelight * (1.0 - active) *
+			                                                 (murrine_style->options.prelight_shade - 1.0));
+
+	params->style_functions->draw_button (cr, &colors, &blended, button,
+	                                      x, y, width, height, horizontal);
+}
+#endif
+
+/* Draws a button, blending the colors of the states while a prelight
+ * or press transition of the widget runs */
+static void
+murrine_style_draw_button_animated (MurrineStyle           *murrine_style,
+                                    GtkWidget              *widget,
+                                    cairo_t                *cr,
+                                    const WidgetParameters *params,
+                                    const ButtonParameters *button,
+                                    int x, int y, int width, int height,
+                                    boolean horizontal)
+{
+#ifdef HAVE_ANIMATION
+	if (murrine_style->options.animation && widget &&
+	    (params->state_type == GTK_STATE_NORMAL ||
+	     params->state_type == GTK_STATE_PRELIGHT ||
+	     params->state_type == GTK_STATE_ACTIVE))
+	{
+		boolean pressed = (params->state_type == GTK_STATE_ACTIVE);
+		double prelight, active;
+
+		prelight = murrine_animation_transition (widget, MRN_TRANSITION_PRELIGHT,
+		                                         pressed || params->state_type == GTK_STATE_PRELIGHT,
+		                                         murrine_style->options.transition_durations[MRN_TRANSITION_PRELIGHT]);
+		active = murrine_animation_transition (widget, MRN_TRANSITION_ACTIVE, pressed,
+		                                       murrine_style->options.transition_durations[MRN_TRANSITION_ACTIVE]);
+
+		if ((prelight > 0.0 && prelight < 1.0) || (active > 0.0 && active < 1.0))
+		{
+			murrine_style_draw_button_blended (murrine_style, cr, params, button, prelight, active,
+			                                   x, y, width, height, horizontal);
+			return;
+		}
+	}
+#endif
+
+	murrine_style_draw_button_list (murrine_style, cr, params, button, x, y, width, height, horizontal);
+}
+
+static void
+murrine_style_draw_tab_list (MurrineStyle           *murrine_style,
+                             cairo_t                *cr,
+                             const WidgetParameters *params,
+                             const TabParameters    *tab,
+                             int x, int y, int width, int height)
+{
+	MurrinePalette *palette = murrine_style_get_palette (murrine_style);
+	MurrineDisplayListKey key;
+	cairo_t *draw_cr;
+
+	if (!palette->display_lists)
+		palette->display_lists = murrine_display_lists_new ();
+
+	murrine_display_list_key_tab (&key, params, tab, width, height);
+
+	draw_cr = murrine_display_list_begin (palette->display_lists, cr, &key, &x, &y);
+	if (draw_cr)
+	{
+		params->style_functions->draw_tab (draw_cr, murrine_style_get_colors (murrine_style), params, tab,
+		                                   x, y, width, height);
+		murrine_display_list_end (palette->display_lists, cr, draw_cr);
+	}
+}
+
 static void
 murrine_style_draw_flat_box (DRAW_ARGS)
 {
@@ -246,7 +502,8 @@ murrine_style_draw_flat_box (DRAW_ARGS)
 	    !strncmp ("cell_odd", detail, 8)))
 	{
 		MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-		MurrineColors *colors = &murrine_style->colors;
+		MurrineColors *colors = murrine_style_get_colors (murrine_style);
+		cairo_pattern_t *stripe;
 		cairo_t       *cr;
 
 		CHECK_ARGS
@@ -257,18 +514,30 @@ murrine_style_draw_flat_box (DRAW_ARGS)
 		WidgetParameters params;
 		CellParameters cell;
 
-		cell.style = murrine_style->cellstyle;
+		cell.style = murrine_style->options.cellstyle;
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
-		STYLE_FUNCTION(draw_selected_cell) (cr, colors, &params, &cell, x, y, width, height);
+		stripe = murrine_style_get_row_stripe (murrine_style, MRN_ROW_STRIPE_SELECTED_CELL,
+		                                       &params, &cell,
+		                                       !strncmp ("cell_odd", detail, 8), height);
+
+		if (stripe)
+		{
+			cairo_translate (cr, x, y);
+			cairo_set_source (cr, stripe);
+			cairo_rectangle (cr, 0, 0, width, height);
+			cairo_fill (cr);
+		}
+		else
+			STYLE_FUNCTION(draw_selected_cell) (cr, colors, &params, &cell, x, y, width, height);
 
 		cairo_destroy (cr);
 	}
 	else if (DETAIL ("tooltip"))
 	{
 		MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-		MurrineColors *colors = &murrine_style->colors;
+		MurrineColors *colors = murrine_style_get_colors (murrine_style);
 		cairo_t       *cr;
 
 		CHECK_ARGS
@@ -293,7 +562,7 @@ murrine_style_draw_flat_box (DRAW_ARGS)
 	else if (DETAIL ("icon_view_item"))
 	{
 		MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-		MurrineColors *colors = &murrine_style->colors;
+		MurrineColors *colors = murrine_style_get_colors (murrine_style);
 		cairo_t       *cr;
 
 		CHECK_ARGS
@@ -314,14 +583,14 @@ murrine_style_draw_flat_box (DRAW_ARGS)
 		if (DETAIL ("base") || DETAIL ("eventbox") || DETAIL ("entry_bg") || DETAIL ("trough"))
 		{
 			MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-			MurrineColors *colors = &murrine_style->colors;
+			MurrineColors *colors = murrine_style_get_colors (murrine_style);
 			cairo_t       *cr;
 			boolean use_rgba = FALSE;
 
 			CHECK_ARGS
 			SANITIZE_SIZE
 
-			use_rgba = (murrine_widget_is_rgba (widget) && murrine_style->rgba);
+			use_rgba = (murrine_widget_is_rgba (widget) && murrine_style->options.rgba);
 
 			if (!use_rgba)
 			{
@@ -379,14 +648,15 @@ murrine_style_draw_flat_box (DRAW_ARGS)
 	if (detail && (!strncmp ("cell_even", detail, 9) || !strncmp ("cell_odd", detail, 8)))
 	{
 		MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-		switch (murrine_style->listviewstyle)
+		switch (murrine_style->options.listviewstyle)
 		{
 			default:
 			case 0:
 				break;
 			case 1:
 			{
-				MurrineColors *colors = &murrine_style->colors;
+				MurrineColors *colors = murrine_style_get_colors (murrine_style);
+				cairo_pattern_t *stripe;
 				cairo_t       *cr;
 
 				CHECK_ARGS
@@ -394,23 +664,37 @@ murrine_style_draw_flat_box (DRAW_ARGS)
 
 				cr = murrine_begin_paint (window, area);
 
-				cairo_translate (cr, x, y);
 				int i;
-				int pos = murrine_style->listviewheaderstyle != 1 ? 2 : 1;
+				int pos = murrine_style->options.listviewheaderstyle != 1 ? 2 : 1;
 
-				murrine_set_color_rgba (cr, &colors->text[GTK_STATE_NORMAL], 0.42);
-				for (i = 2; i < height; i+=4)
+				stripe = murrine_style_get_row_stripe (murrine_style, MRN_ROW_STRIPE_LISTVIEW,
+				                                       NULL, NULL,
+				                                       !strncmp ("cell_odd", detail, 8), height);
+
+				if (stripe)
 				{
-					cairo_rectangle (cr, -pos, i, 1, 1);
+					cairo_translate (cr, x-pos, y);
+					cairo_set_source (cr, stripe);
+					cairo_rectangle (cr, 0, 0, 1, height);
 					cairo_fill (cr);
 				}
+				else
+				{
+					cairo_translate (cr, x, y);
+					murrine_set_color_rgba (cr, &colors->text[GTK_STATE_NORMAL], 0.42);
+					for (i = 2; i < height; i+=4)
+					{
+						cairo_rectangle (cr, -pos, i, 1, 1);
+						cairo_fill (cr);
+					}
+				}
 
 				cairo_destroy (cr);
 				break;
 			}
 			case 2:
 			{
-				MurrineColors *colors = &murrine_style->colors;
+				MurrineColors *colors = murrine_style_get_colors (murrine_style);
 				cairo_t       *cr;
 
 				CHECK_ARGS
@@ -418,7 +702,7 @@ murrine_style_draw_flat_box (DRAW_ARGS)
 
 				cr = murrine_begin_paint (window, area);
 
-				cairo_translate (cr, murrine_style->listviewheaderstyle != 1 ? x-1 : x, y);
+				cairo_translate (cr, murrine_style->options.listviewheaderstyle != 1 ? x-1 : x, y);
 
 				cairo_move_to (cr, -0.5, 0);
 				cairo_line_to (cr, -0.5, height);
@@ -436,7 +720,7 @@ static void
 murrine_style_draw_shadow (DRAW_ARGS)
 {
 	MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t       *cr;
 
 	CHECK_ARGS
@@ -492,9 +776,9 @@ murrine_style_draw_shadow (DRAW_ARGS)
 		}
 
 		/* Focus color */
-		if (murrine_style->has_focus_color)
+		if (murrine_style->options.has_focus_color)
 		{
-			murrine_gdk_color_to_rgb (&murrine_style->focus_color, &focus.color.r,
+			murrine_gdk_color_to_rgb (&murrine_style->options.focus_color, &focus.color.r,
 			                                                       &focus.color.g,
 			                                                       &focus.color.b);
 			focus.has_color = TRUE;
@@ -504,16 +788,16 @@ murrine_style_draw_shadow (DRAW_ARGS)
 
 
 		if (g_strcmp0 (gtk_widget_get_name (widget), "search-entry") == 0)
-			STYLE_FUNCTION(draw_search_entry) (cr, &murrine_style->colors, &params, &focus,
+			STYLE_FUNCTION(draw_search_entry) (cr, murrine_style_get_colors (murrine_style), &params, &focus,
 							   x, y, width, height);
 		else if (GTK_IS_SPIN_BUTTON (widget))
-			STYLE_FUNCTION(draw_entry) (cr, &murrine_style->colors, &params, &focus,
+			STYLE_FUNCTION(draw_entry) (cr, murrine_style_get_colors (murrine_style), &params, &focus,
 							       x, y-1, width, height+2);
                 else if (murrine_is_combo_box_entry (widget))
-			STYLE_FUNCTION(draw_entry) (cr, &murrine_style->colors, &params, &focus,
+			STYLE_FUNCTION(draw_entry) (cr, murrine_style_get_colors (murrine_style), &params, &focus,
 						    x, y+2, width, height-4);
 		else
-			STYLE_FUNCTION(draw_entry) (cr, &murrine_style->colors, &params, &focus,
+			STYLE_FUNCTION(draw_entry) (cr, murrine_style_get_colors (murrine_style), &params, &focus,
 						    x, y, width, height);
 	}
 	else if (DETAIL ("frame") && widget && MRN_IS_STATUSBAR (widget->parent))
@@ -556,7 +840,7 @@ murrine_style_draw_shadow (DRAW_ARGS)
 	else if (DETAIL ("pager") || DETAIL ("pager-frame"))
 	{
 		murrine_rounded_rectangle (cr, x+0.5, y+0.5, width-1, height-1,
-		                           CLAMP (murrine_style->roundness, 0, 3),
+		                           CLAMP (murrine_style->options.roundness, 0, 3),
 		                           MRN_CORNER_ALL);
 		murrine_set_color_rgb (cr, &colors->shade[5]);
 		cairo_stroke (cr);
@@ -588,7 +872,7 @@ murrine_style_draw_box_gap (DRAW_ARGS,
                             gint            gap_width)
 {
 	MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t       *cr;
 
 	CHECK_ARGS
@@ -697,7 +981,6 @@ static void
 murrine_style_draw_extension (DRAW_ARGS, GtkPositionType gap_side)
 {
 	MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
 	cairo_t       *cr;
 
 	CHECK_ARGS
@@ -729,7 +1012,7 @@ murrine_style_draw_extension (DRAW_ARGS, GtkPositionType gap_side)
 				break;
 		}
 
-		STYLE_FUNCTION(draw_tab) (cr, colors, &params, &tab, x, y, width, height);
+		murrine_style_draw_tab_list (murrine_style, cr, &params, &tab, x, y, width, height);
 	}
 	else
 	{
@@ -745,7 +1028,7 @@ static void
 murrine_style_draw_handle (DRAW_ARGS, GtkOrientation orientation)
 {
 	MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t       *cr;
 
 	CHECK_ARGS
@@ -760,7 +1043,7 @@ murrine_style_draw_handle (DRAW_ARGS, GtkOrientation orientation)
 
 		handle.type = MRN_HANDLE_TOOLBAR;
 		handle.horizontal = (orientation == GTK_ORIENTATION_HORIZONTAL);
-		handle.style = murrine_style->handlestyle;
+		handle.style = murrine_style->options.handlestyle;
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
@@ -773,7 +1056,7 @@ murrine_style_draw_handle (DRAW_ARGS, GtkOrientation orientation)
 
 		handle.type = MRN_HANDLE_SPLITTER;
 		handle.horizontal = (orientation == GTK_ORIENTATION_HORIZONTAL);
-		handle.style = murrine_style->handlestyle;
+		handle.style = murrine_style->options.handlestyle;
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
@@ -786,7 +1069,7 @@ murrine_style_draw_handle (DRAW_ARGS, GtkOrientation orientation)
 
 		handle.type = MRN_HANDLE_TOOLBAR;
 		handle.horizontal = (orientation == GTK_ORIENTATION_HORIZONTAL);
-		handle.style = murrine_style->handlestyle;
+		handle.style = murrine_style->options.handlestyle;
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
@@ -800,7 +1083,7 @@ static void
 murrine_style_draw_box (DRAW_ARGS)
 {
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t *cr;
 
 	CHECK_ARGS
@@ -813,7 +1096,7 @@ murrine_style_draw_box (DRAW_ARGS)
 	{
 		WidgetParameters params;
 		gboolean horizontal;
-		int menubarstyle = murrine_style->menubarstyle;
+		int menubarstyle = murrine_style->options.menubarstyle;
 		int offset = 0;
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
@@ -843,7 +1126,7 @@ murrine_style_draw_box (DRAW_ARGS)
 	{
 		WidgetParameters params;
 		ListViewHeaderParameters header;
-		header.style = murrine_style->listviewheaderstyle;
+		header.style = murrine_style->options.listviewheaderstyle;
 
 		gint columns, column_index;
 		gboolean resizable = TRUE;
@@ -898,9 +1181,9 @@ murrine_style_draw_box (DRAW_ARGS)
 		button.draw_glaze = TRUE;
 
 		/* Default button color */
-		if (murrine_style->has_default_button_color)
+		if (murrine_style->options.has_default_button_color)
 		{
-			murrine_gdk_color_to_rgb (&murrine_style->default_button_color, &button.default_button_color.r,
+			murrine_gdk_color_to_rgb (&murrine_style->options.default_button_color, &button.default_button_color.r,
 				                                                        &button.default_button_color.g,
 				                                                        &button.default_button_color.b);
 			button.has_default_button_color = TRUE;
@@ -910,12 +1193,12 @@ murrine_style_draw_box (DRAW_ARGS)
 
 		boolean horizontal = TRUE;
 		if (((float)width/height<0.5) ||
-		    (murrine_style->highlight_shade != 1.0 && murrine_style->glazestyle > 0 && width<height))
+		    (murrine_style->options.highlight_shade != 1.0 && murrine_style->options.glazestyle > 0 && width<height))
 			horizontal = FALSE;
 
 		if ((widget && (MRN_IS_COMBO_BOX_ENTRY (widget->parent) || MRN_IS_COMBO (widget->parent))))
 		{
-			if (murrine_style->roundness > 0)
+			if (murrine_style->options.roundness > 0)
 			{
 				if (params.ltr)
 				{
@@ -938,7 +1221,7 @@ murrine_style_draw_box (DRAW_ARGS)
 				width++;
 			}
 
-			if (murrine_style->reliefstyle > 1)
+			if (murrine_style->options.reliefstyle > 1)
 				params.reliefstyle = 1;
 		}
 
@@ -957,13 +1240,13 @@ murrine_style_draw_box (DRAW_ARGS)
 		if (MRN_IS_COMBO_BOX_ENTRY (widget->parent) ||
 		    (GTK_IS_COMBO_BOX (widget->parent) &&
 		     gtk_combo_box_get_has_entry (GTK_COMBO_BOX (widget->parent))))
-			STYLE_FUNCTION(draw_button) (cr, &murrine_style->colors, &params, &button, x+1, y+4, width-1, height-8, horizontal);
+			murrine_style_draw_button_animated (murrine_style, widget, cr, &params, &button, x+1, y+4, width-1, height-8, horizontal);
 		else if (!MRN_IS_COMBO_BOX(widget->parent) ||
 			 MRN_IS_COMBO (widget->parent))
 		{
 			if (GTK_IS_TOGGLE_BUTTON (widget))
 				button.fill_shade = 0.934;
-			STYLE_FUNCTION(draw_button) (cr, &murrine_style->colors, &params, &button, x, y+4, width, height-8, horizontal);
+			murrine_style_draw_button_animated (murrine_style, widget, cr, &params, &button, x, y+4, width, height-8, horizontal);
 		}
 		else
 		{
@@ -974,12 +1257,12 @@ murrine_style_draw_box (DRAW_ARGS)
 
 			combobox.as_list = FALSE;
 			combobox.box_w = MIN (22, arrow_size + 2 * MAX (params.xthickness, params.ythickness) + 2);
-			combobox.style = murrine_style->comboboxstyle;
-			combobox.prelight_shade = murrine_style->prelight_shade;
+			combobox.style = murrine_style->options.comboboxstyle;
+			combobox.prelight_shade = murrine_style->options.prelight_shade;
 
 			gtk_widget_style_get (widget->parent, "appears-as-list", &combobox.as_list, NULL);
 
-			STYLE_FUNCTION(draw_combobox) (cr, murrine_style->colors, params, &combobox, x, y+4, width, height-8, horizontal);
+			STYLE_FUNCTION(draw_combobox) (cr, *murrine_style_get_colors (murrine_style), params, &combobox, x, y+4, width, height-8, horizontal);
 		}
 	}
 	else if (DETAIL ("spinbutton_up") || DETAIL ("spinbutton_down"))
@@ -1014,10 +1297,10 @@ murrine_style_draw_box (DRAW_ARGS)
 					params.corners = MRN_CORNER_BOTTOMLEFT;
 			}
 
-			if (murrine_style->reliefstyle > 1)
+			if (murrine_style->options.reliefstyle > 1)
 				params.reliefstyle = 1;
 
-			STYLE_FUNCTION(draw_spinbutton_down) (cr, &murrine_style->colors, &params, x, y, width, height);
+			STYLE_FUNCTION(draw_spinbutton_down) (cr, murrine_style_get_colors (murrine_style), &params, x, y, width, height);
 		}
 	}
 	else if (DETAIL ("spinbutton"))
@@ -1032,14 +1315,14 @@ murrine_style_draw_box (DRAW_ARGS)
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
-		spinbutton.style = murrine_style->spinbuttonstyle;
+		spinbutton.style = murrine_style->options.spinbuttonstyle;
 
 		boolean horizontal = TRUE;
 		if (((float)width/height<0.5) ||
-		    (murrine_style->highlight_shade != 1.0 && murrine_style->glazestyle > 0 && width<height))
+		    (murrine_style->options.highlight_shade != 1.0 && murrine_style->options.glazestyle > 0 && width<height))
 			horizontal = FALSE;
 
-		if (murrine_style->roundness > 0)
+		if (murrine_style->options.roundness > 0)
 		{
 			if (params.ltr)
 			{
@@ -1062,7 +1345,7 @@ murrine_style_draw_box (DRAW_ARGS)
 			width++;
 		}
 
-		if (murrine_style->reliefstyle > 1)
+		if (murrine_style->options.reliefstyle > 1)
 			params.reliefstyle = 1;
 
 		if (!params.mrn_gradient.use_rgba)
@@ -1072,7 +1355,7 @@ murrine_style_draw_box (DRAW_ARGS)
 			cairo_fill (cr);
 		}
 
-		STYLE_FUNCTION(draw_spinbutton) (cr, &murrine_style->colors, &params, &spinbutton, x, y, width, height, horizontal);
+		STYLE_FUNCTION(draw_spinbutton) (cr, murrine_style_get_colors (murrine_style), &params, &spinbutton, x, y, width, height, horizontal);
 	}
 	else if (detail && g_str_has_prefix (detail, "trough") && widget && MRN_IS_SCALE (widget))
 	{
@@ -1086,7 +1369,7 @@ murrine_style_draw_box (DRAW_ARGS)
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 		params.corners = MRN_CORNER_ALL;
 
-		STYLE_FUNCTION(draw_scale_trough) (cr, &murrine_style->colors,
+		STYLE_FUNCTION(draw_scale_trough) (cr, murrine_style_get_colors (murrine_style),
 		                                   &params, &slider,
 		                                   x, y, width, height);
 	}
@@ -1145,7 +1428,7 @@ murrine_style_draw_box (DRAW_ARGS)
 		scrollbar.horizontal   = TRUE;
 		scrollbar.junction     = murrine_scrollbar_get_junction (widget);
 		scrollbar.steppers     = murrine_scrollbar_visible_steppers (widget);
-		scrollbar.stepperstyle = murrine_style->stepperstyle;
+		scrollbar.stepperstyle = murrine_style->options.stepperstyle;
 		scrollbar.within_bevel = within_bevel;
 		gtk_widget_style_get (widget, "stepper-size", &scrollbar.steppersize, NULL);
 
@@ -1157,7 +1440,7 @@ murrine_style_draw_box (DRAW_ARGS)
 		if (MRN_IS_RANGE (widget))
 			scrollbar.horizontal = GTK_RANGE (widget)->orientation == GTK_ORIENTATION_HORIZONTAL;
 
-		if (murrine_style->stepperstyle != 1 && murrine_style->stepperstyle != 3 && !params.mrn_gradient.use_rgba)
+		if (murrine_style->options.stepperstyle != 1 && murrine_style->options.stepperstyle != 3 && !params.mrn_gradient.use_rgba)
 		{
 			if (scrollbar.horizontal)
 			{
@@ -1178,9 +1461,11 @@ murrine_style_draw_box (DRAW_ARGS)
 		WidgetParameters      params;
 		ProgressBarParameters progressbar;
 		gdouble               elapsed = 0.0;
+		gint                  first_offset, offset;
+		gboolean              prerendered = FALSE;
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
-		progressbar.style = murrine_style->progressbarstyle;
+		progressbar.style = murrine_style->options.progressbarstyle;
 
 		if (widget && MRN_IS_PROGRESS_BAR (widget))
 			progressbar.orientation = gtk_progress_bar_get_orientation (GTK_PROGRESS_BAR (widget));
@@ -1196,29 +1481,46 @@ murrine_style_draw_box (DRAW_ARGS)
 		}
 
 #ifdef HAVE_ANIMATION
-		if(murrine_style->animation && MRN_IS_PROGRESS_BAR (widget))
-		{
-			gboolean activity_mode = GTK_PROGRESS (widget)->activity_mode;
-
-			if (!activity_mode)
-				murrine_animation_progressbar_add ((gpointer)widget);
-		}
+		/* Activity mode bars are moved by gtk_progress_bar_pulse (), they
+		 * were never added to the animated widgets */
+		if (murrine_style->options.animation && MRN_IS_PROGRESS_BAR (widget) &&
+		    !GTK_PROGRESS (widget)->activity_mode)
+			elapsed = murrine_animation_progressbar_update (widget, window, x-1, y, width+2, height);
+		else
+			elapsed = murrine_animation_elapsed (widget);
+#endif
 
-		elapsed = murrine_animation_elapsed (widget);
+#ifndef HAVE_ANIMATIONRTL
+		first_offset = 1;
+		offset = 10-(int)(elapsed*10.0) % 10;
+#else
+		first_offset = 10;
+		offset = 10+(int)(elapsed*10.0) % 10;
 #endif
 
 		/* The x-1 and width+2 are to make the fill cover the left and
 		 * right-hand sides of the trough box */
 
-#ifndef HAVE_ANIMATIONRTL
-		STYLE_FUNCTION(draw_progressbar_fill) (cr, colors, &params, &progressbar,
-		                                       x-1, y, width+2, height,
-		                                       10-(int)(elapsed*10.0) % 10);
-#else
-		STYLE_FUNCTION(draw_progressbar_fill) (cr, colors, &params, &progressbar,
-		                                       x-1, y, width+2, height,
-		                                       10+(int)(elapsed*10.0) % 10);
+#ifdef HAVE_ANIMATION
+		/* the frames of animated bars may be rendered ahead of time */
+		if (murrine_style->options.animation && MRN_IS_PROGRESS_BAR (widget))
+		{
+			MurrinePalette *palette = murrine_style_get_palette (murrine_style);
+
+			if (!palette->frame_cache)
+				palette->frame_cache = murrine_frame_cache_new ();
+
+			prerendered = murrine_frame_cache_draw_progressbar (palette->frame_cache, cr, colors,
+			                                                    &params, &progressbar,
+			                                                    x-1, y, width+2, height,
+			                                                    first_offset, offset);
+		}
 #endif
+
+		if (!prerendered)
+			STYLE_FUNCTION(draw_progressbar_fill) (cr, colors, &params, &progressbar,
+			                                       x-1, y, width+2, height,
+			                                       offset);
 	}
 	else if (DETAIL ("entry-progress"))
 	{
@@ -1372,17 +1674,17 @@ murrine_style_draw_box (DRAW_ARGS)
 		if (params.disabled)
 			params.reliefstyle = 0;
 		
-		if (murrine_style->sliderstyle < 2)
-			STYLE_FUNCTION(draw_button) (cr, &murrine_style->colors, &params, &button, x, y, width, height, horizontal);
+		if (murrine_style->options.sliderstyle < 2)
+			STYLE_FUNCTION(draw_button) (cr, murrine_style_get_colors (murrine_style), &params, &button, x, y, width, height, horizontal);
 		else
-			STYLE_FUNCTION(draw_slider) (cr, &murrine_style->colors, &params, &slider, x, y, width-1, height-1);
+			STYLE_FUNCTION(draw_slider) (cr, murrine_style_get_colors (murrine_style), &params, &slider, x, y, width-1, height-1);
 
-		if (murrine_style->sliderstyle == 1 || murrine_style->sliderstyle == 3)
+		if (murrine_style->options.sliderstyle == 1 || murrine_style->options.sliderstyle == 3)
 		{
 			HandleParameters handle;
-			handle.style = murrine_style->handlestyle;
+			handle.style = murrine_style->options.handlestyle;
 
-			STYLE_FUNCTION(draw_slider_handle) (cr, &murrine_style->colors, &params, &handle, x, y, width, height, horizontal);
+			STYLE_FUNCTION(draw_slider_handle) (cr, murrine_style_get_colors (murrine_style), &params, &handle, x, y, width, height, horizontal);
 		}
 	}
 	else if (DETAIL ("optionmenu"))
@@ -1402,14 +1704,14 @@ murrine_style_draw_box (DRAW_ARGS)
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
-		if (murrine_style->comboboxstyle > 0)
+		if (murrine_style->options.comboboxstyle > 0)
 		{
 			ComboBoxParameters combobox;
 			combobox.as_list = FALSE;
 			combobox.box_w = indicator_size.width+indicator_spacing.left+indicator_spacing.right+3;
-			combobox.style = murrine_style->comboboxstyle;
-			combobox.prelight_shade = murrine_style->prelight_shade;
-			STYLE_FUNCTION(draw_combobox) (cr, murrine_style->colors, params, &combobox, x, y, width, height, TRUE);
+			combobox.style = murrine_style->options.comboboxstyle;
+			combobox.prelight_shade = murrine_style->options.prelight_shade;
+			STYLE_FUNCTION(draw_combobox) (cr, *murrine_style_get_colors (murrine_style), params, &combobox, x, y, width, height, TRUE);
 		}
 		else
 			STYLE_FUNCTION(draw_optionmenu) (cr, colors, &params, &optionmenu, x, y, width, height);
@@ -1420,15 +1722,15 @@ murrine_style_draw_box (DRAW_ARGS)
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
-		if (widget && !(MRN_IS_MENU_BAR (widget->parent) && murrine_style->menubaritemstyle))
+		if (widget && !(MRN_IS_MENU_BAR (widget->parent) && murrine_style->options.menubaritemstyle))
 		{
-			if (murrine_style->menustyle != 1 || (MRN_IS_MENU_BAR (widget->parent) && !murrine_style->menubaritemstyle))
-				STYLE_FUNCTION(draw_menuitem) (cr, colors, &params, x, y, width, height, murrine_style->menuitemstyle);
+			if (murrine_style->options.menustyle != 1 || (MRN_IS_MENU_BAR (widget->parent) && !murrine_style->options.menubaritemstyle))
+				STYLE_FUNCTION(draw_menuitem) (cr, colors, &params, x, y, width, height, murrine_style->options.menuitemstyle);
 			else
-				STYLE_FUNCTION(draw_menuitem) (cr, colors, &params, x+3, y, width-3, height, murrine_style->menuitemstyle);
+				STYLE_FUNCTION(draw_menuitem) (cr, colors, &params, x+3, y, width-3, height, murrine_style->options.menuitemstyle);
 		}
 
-		if (widget && MRN_IS_MENU_BAR (widget->parent) && murrine_style->menubaritemstyle)
+		if (widget && MRN_IS_MENU_BAR (widget->parent) && murrine_style->options.menubaritemstyle)
 		{
 			ButtonParameters button;
 			button.has_default_button_color = FALSE;
@@ -1457,17 +1759,17 @@ murrine_style_draw_box (DRAW_ARGS)
 		scrollbar.has_color      = FALSE;
 		scrollbar.horizontal     = TRUE;
 		scrollbar.junction       = murrine_scrollbar_get_junction (widget);
-		scrollbar.handlestyle    = murrine_style->handlestyle;
+		scrollbar.handlestyle    = murrine_style->options.handlestyle;
 		scrollbar.steppers       = murrine_scrollbar_visible_steppers (widget);
-		scrollbar.style          = murrine_style->scrollbarstyle;
-		scrollbar.stepperstyle   = murrine_style->stepperstyle;
-		scrollbar.prelight_shade = murrine_style->prelight_shade;
+		scrollbar.style          = murrine_style->options.scrollbarstyle;
+		scrollbar.stepperstyle   = murrine_style->options.stepperstyle;
+		scrollbar.prelight_shade = murrine_style->options.prelight_shade;
 		gtk_widget_style_get (widget, "stepper-size", &scrollbar.steppersize, NULL);
 
 		if (MRN_IS_RANGE (widget))
 			scrollbar.horizontal = GTK_RANGE (widget)->orientation == GTK_ORIENTATION_HORIZONTAL;
 
-		if (murrine_style->colorize_scrollbar)
+		if (murrine_style->options.colorize_scrollbar)
 		{
 			scrollbar.color = colors->spot[1];
 			scrollbar.has_color = TRUE;
@@ -1480,6 +1782,10 @@ murrine_style_draw_box (DRAW_ARGS)
 
 		if (DETAIL ("slider"))
 		{
+			const MurrineColors *slider_colors = colors;
+#ifdef HAVE_ANIMATION
+			MurrineColors faded;
+#endif
 			int trough_border = 0;
 			int trough_under_steppers = 1;
 
@@ -1492,16 +1798,45 @@ murrine_style_draw_box (DRAW_ARGS)
 			    trough_under_steppers == 0 ||
 			    scrollbar.stepperstyle == 2 ||
 			    scrollbar.stepperstyle == 3 ||
-			    murrine_style->roundness == 1)
+			    murrine_style->options.roundness == 1)
 				params.corners = MRN_CORNER_ALL;
 			else
 				params.corners = MRN_CORNER_NONE;
 
-			STYLE_FUNCTION(draw_scrollbar_slider) (cr, colors, &params, &scrollbar, x, y, width, height);
+#ifdef HAVE_ANIMATION
+			if (murrine_style->options.animation && widget &&
+			    (state_type == GTK_STATE_NORMAL || state_type == GTK_STATE_PRELIGHT))
+			{
+				double hover = murrine_animation_transition (widget, MRN_TRANSITION_SLIDER, params.prelight,
+				                                             murrine_style->options.transition_durations[MRN_TRANSITION_SLIDER]);
+
+				/* only the fill of the slider follows the pointer */
+				if (hover > 0.0 && hover < 1.0)
+				{
+					if (scrollbar.has_color)
+					{
+						MurrineRGB prelight;
+
+						murrine_shade (&scrollbar.color, scrollbar.prelight_shade, &prelight);
+						murrine_mix_color (&scrollbar.color, &prelight, hover, &scrollbar.color);
+						params.prelight = FALSE;
+					}
+					else
+					{
+						faded = *colors;
+						murrine_mix_color (&colors->bg[GTK_STATE_NORMAL], &colors->bg[GTK_STATE_PRELIGHT],
+						                   hover, &faded.bg[state_type]);
+						slider_colors = &faded;
+					}
+				}
+			}
+#endif
+
+			STYLE_FUNCTION(draw_scrollbar_slider) (cr, slider_colors, &params, &scrollbar, x, y, width, height);
 		}
 		else
 		{
-			if (murrine_style->roundness > 1)
+			if (murrine_style->options.roundness > 1)
 			{
 				ScrollBarStepperParameters stepper;
 				GdkRectangle this_rectangle = { x, y, width, height };
@@ -1523,7 +1858,7 @@ murrine_style_draw_box (DRAW_ARGS)
 						params.corners = MRN_CORNER_TOPRIGHT | MRN_CORNER_BOTTOMRIGHT;
 				}
 			}
-			else if (murrine_style->roundness == 1)
+			else if (murrine_style->options.roundness == 1)
 				params.corners = MRN_CORNER_ALL;
 			else
 				params.corners = MRN_CORNER_NONE;
@@ -1550,7 +1885,7 @@ murrine_style_draw_box (DRAW_ARGS)
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
 		murrine_set_toolbar_parameters (&toolbar, widget, window, x, y);
-		toolbar.style = murrine_style->toolbarstyle;
+		toolbar.style = murrine_style->options.toolbarstyle;
 
 		if ((DETAIL ("handlebox_bin") || DETAIL ("dockitem_bin")) && MRN_IS_BIN (widget))
 		{
@@ -1579,7 +1914,7 @@ murrine_style_draw_box (DRAW_ARGS)
 
 		murrine_set_widget_parameters (widget, style, state_type, &params);
 
-		STYLE_FUNCTION(draw_menu_frame) (cr, colors, &params, x, y, width, height, murrine_style->menustyle);
+		STYLE_FUNCTION(draw_menu_frame) (cr, colors, &params, x, y, width, height, murrine_style->options.menustyle);
 	}
 	else if (DETAIL ("infobar") ||
 	         DETAIL ("infobar-error") ||
@@ -1642,7 +1977,7 @@ static void
 murrine_style_draw_option (DRAW_ARGS)
 {
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t *cr;
 
 	CHECK_ARGS
@@ -1662,16 +1997,18 @@ murrine_style_draw_option (DRAW_ARGS)
 	double trans = 1.0;
 
 #ifdef HAVE_ANIMATION
-	if (murrine_style->animation)
+	if (murrine_style->options.animation)
 		murrine_animation_connect_checkbox (widget);
 
-	if (murrine_style->animation &&
+	if (murrine_style->options.animation &&
 	    MRN_IS_CHECK_BUTTON (widget) &&
 	    murrine_animation_is_animated (widget) &&
 	    !gtk_toggle_button_get_inconsistent (GTK_TOGGLE_BUTTON (widget)))
 	{
 		gfloat elapsed = murrine_animation_elapsed (widget);
 		trans = sqrt (sqrt (MIN (elapsed/CHECK_ANIMATION_TIME, 1.0)));
+
+		murrine_animation_set_damage (widget, window, x, y, width, height);
 	}
 #endif
 
@@ -1684,7 +2021,7 @@ static void
 murrine_style_draw_check (DRAW_ARGS)
 {
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t *cr;
 
 	CHECK_ARGS
@@ -1704,15 +2041,17 @@ murrine_style_draw_check (DRAW_ARGS)
 	double trans = 1.0;
 
 #ifdef HAVE_ANIMATION
-	if (murrine_style->animation)
+	if (murrine_style->options.animation)
 		murrine_animation_connect_checkbox (widget);
 
-	if (murrine_style->animation && MRN_IS_CHECK_BUTTON (widget) &&
+	if (murrine_style->options.animation && MRN_IS_CHECK_BUTTON (widget) &&
 	    murrine_animation_is_animated (widget) &&
 	    !gtk_toggle_button_get_inconsistent (GTK_TOGGLE_BUTTON (widget)))
 	{
 		gfloat elapsed = murrine_animation_elapsed (widget);
 		trans = sqrt (sqrt (MIN (elapsed/CHECK_ANIMATION_TIME, 1.0)));
+
+		murrine_animation_set_damage (widget, window, x, y, width, height);
 	}
 #endif
 
@@ -1725,7 +2064,7 @@ static void
 murrine_style_draw_tab (DRAW_ARGS)
 {
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 
 	cairo_t *cr;
 
@@ -1739,7 +2078,7 @@ murrine_style_draw_tab (DRAW_ARGS)
 
 	arrow.type      = MRN_ARROW_COMBO;
 	arrow.direction = MRN_DIRECTION_DOWN;
-	arrow.style     = murrine_style->arrowstyle;
+	arrow.style     = murrine_style->options.arrowstyle;
 
 	murrine_set_widget_parameters (widget, style, state_type, &params);
 
@@ -1763,7 +2102,7 @@ murrine_style_draw_vline (GtkStyle     *style,
 	GtkWidget* toplevel = gtk_widget_get_toplevel (widget);
 
 	MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t *cr;
 
 	CHECK_ARGS
@@ -1772,11 +2111,11 @@ murrine_style_draw_vline (GtkStyle     *style,
 
 	SeparatorParameters separator;
 	separator.horizontal = FALSE;
-	separator.style = murrine_style->separatorstyle;
+	separator.style = murrine_style->options.separatorstyle;
 
 	WidgetParameters params;
 
-	params.contrast = murrine_style->contrast;
+	params.contrast = murrine_style->options.contrast;
 	params.style = MRN_STYLE_MURRINE;
 	if (murrine_widget_is_rgba (toplevel))
 	{
@@ -1809,7 +2148,7 @@ murrine_style_draw_hline (GtkStyle     *style,
 	GtkWidget* toplevel = gtk_widget_get_toplevel (widget);
 
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t *cr;
 
 	CHECK_ARGS
@@ -1818,11 +2157,11 @@ murrine_style_draw_hline (GtkStyle     *style,
 
 	SeparatorParameters separator;
 	separator.horizontal = TRUE;
-	separator.style = murrine_style->separatorstyle;
+	separator.style = murrine_style->options.separatorstyle;
 
 	WidgetParameters params;
 
-	params.contrast = murrine_style->contrast;
+	params.contrast = murrine_style->options.contrast;
 	params.style = MRN_STYLE_MURRINE;
 	if (murrine_widget_is_rgba (toplevel))
 	{
@@ -1841,7 +2180,7 @@ murrine_style_draw_shadow_gap (DRAW_ARGS,
                                gint            gap_width)
 {
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	const MurrineColors *colors = &murrine_style->colors;
+	const MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t *cr;
 
 	CHECK_ARGS
@@ -1891,7 +2230,7 @@ murrine_style_draw_resize_grip (GtkStyle      *style,
                                 gint          height)
 {
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 
 	cairo_t *cr;
 
@@ -1936,7 +2275,7 @@ murrine_style_draw_arrow (GtkStyle     *style,
                           gint          height)
 {
 	MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	cairo_t *cr;
 
 	CHECK_ARGS
@@ -1955,7 +2294,7 @@ murrine_style_draw_arrow (GtkStyle     *style,
 
 	arrow.type = MRN_ARROW_NORMAL;
 	arrow.direction = (MurrineDirection)arrow_type;
-	arrow.style = murrine_style->arrowstyle;
+	arrow.style = murrine_style->options.arrowstyle;
 
 	murrine_set_widget_parameters (widget, style, state_type, &params);
 
@@ -2082,12 +2421,12 @@ murrine_style_draw_layout (GtkStyle     *style,
 		gdk_gc_set_clip_rectangle (gc, area);
 
 	if (widget && (state_type == GTK_STATE_INSENSITIVE || 
-	    (MURRINE_STYLE (style)->textstyle != 0 &&
+	    (MURRINE_STYLE (style)->options.textstyle != 0 &&
 	     state_type != GTK_STATE_PRELIGHT &&
 	     !(DETAIL ("cellrenderertext") && state_type == GTK_STATE_NORMAL))))
 	{
 		MurrineStyle *murrine_style = MURRINE_STYLE (style);
-		MurrineColors *colors = &murrine_style->colors;
+		MurrineColors *colors = murrine_style_get_colors (murrine_style);
 		cairo_t *cr;
 
 		WidgetParameters params;
@@ -2097,11 +2436,11 @@ murrine_style_draw_layout (GtkStyle     *style,
 		GdkColor etched;
 		MurrineRGB temp;
 
-		double shade_level = murrine_style->text_shade;
+		double shade_level = murrine_style->options.text_shade;
 		double xos = 0;
 		double yos = 0;
 
-		switch (murrine_style->textstyle)
+		switch (murrine_style->options.textstyle)
 		{
 			case 1:
 				yos = +0.5;
@@ -2192,7 +2531,7 @@ murrine_style_draw_layout (GtkStyle     *style,
 	if (DETAIL ("accellabel"))
 	{
 		MurrineStyle *murrine_style = MURRINE_STYLE (style);
-		MurrineColors *colors = &murrine_style->colors;
+		MurrineColors *colors = murrine_style_get_colors (murrine_style);
 
 		WidgetParameters params;
 
@@ -2235,7 +2574,7 @@ murrine_style_draw_expander (GtkStyle        *style,
                              GtkExpanderStyle expander_style)
 {
 	MurrineStyle  *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
         MurrineRGB treeview_expander_color;
 
 	cairo_t *cr;
@@ -2256,12 +2595,12 @@ murrine_style_draw_expander (GtkStyle        *style,
 
 	expander.expander_style = expander_style;
 	expander.text_direction = murrine_get_direction (widget);
-	expander.arrowstyle = murrine_style->arrowstyle;
-	expander.style = murrine_style->expanderstyle;
+	expander.arrowstyle = murrine_style->options.arrowstyle;
+	expander.style = murrine_style->options.expanderstyle;
 
-	if (murrine_style->has_treeview_expander_color)
+	if (murrine_style->options.has_treeview_expander_color)
 	{
-		murrine_gdk_color_to_rgb (&murrine_style->treeview_expander_color,
+		murrine_gdk_color_to_rgb (&murrine_style->options.treeview_expander_color,
 					  &treeview_expander_color.r,
 					  &treeview_expander_color.g,
 					  &treeview_expander_color.b);
@@ -2282,7 +2621,7 @@ murrine_style_draw_focus (GtkStyle *style, GdkWindow *window, GtkStateType state
                           gint x, gint y, gint width, gint height)
 {
 	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	MurrineColors *colors = &murrine_style->colors;
+	MurrineColors *colors = murrine_style_get_colors (murrine_style);
 	WidgetParameters params;
 	FocusParameters focus;
 	guint8* dash_list;
@@ -2293,7 +2632,7 @@ murrine_style_draw_focus (GtkStyle *style, GdkWindow *window, GtkStateType state
 	SANITIZE_SIZE
 
 	/* Just return if focus drawing is disabled. */
-	if (murrine_style->focusstyle == 0)
+	if (murrine_style->options.focusstyle == 0)
 		return;
 
 	cr = gdk_cairo_create (window);
@@ -2320,7 +2659,7 @@ murrine_style_draw_focus (GtkStyle *style, GdkWindow *window, GtkStateType state
 	focus.interior = FALSE;
 	focus.line_width = 1;
 	focus.padding = 1;
-	focus.style = murrine_style->focusstyle;
+	focus.style = murrine_style->options.focusstyle;
 	dash_list = NULL;
 
 	if (widget)
@@ -2443,9 +2782,9 @@ murrine_style_draw_focus (GtkStyle *style, GdkWindow *window, GtkStateType state
 	}
 
 	/* Focus color */
-	if (murrine_style->has_focus_color)
+	if (murrine_style->options.has_focus_color)
 	{
-		murrine_gdk_color_to_rgb (&murrine_style->focus_color, &focus.color.r,
+		murrine_gdk_color_to_rgb (&murrine_style->options.focus_color, &focus.color.r,
 		                                                       &focus.color.g,
 		                                                       &focus.color.b);
 		focus.has_color = TRUE;
@@ -2453,6 +2792,18 @@ murrine_style_draw_focus (GtkStyle *style, GdkWindow *window, GtkStateType state
 	else
 		focus.color = colors->bg[GTK_STATE_SELECTED];
 
+#ifdef HAVE_ANIMATION
+	/* fade the ring in from the background */
+	if (murrine_style->options.animation && widget)
+	{
+		double fade = murrine_animation_transition (widget, MRN_TRANSITION_FOCUS, TRUE,
+		                                            murrine_style->options.transition_durations[MRN_TRANSITION_FOCUS]);
+
+		if (fade < 1.0)
+			murrine_mix_color (&params.parentbg, &focus.color, fade, &focus.color);
+	}
+#endif
+
 	STYLE_FUNCTION(draw_focus) (cr, colors, &params, &focus, x, y+2, width, height-4);
 
 	g_free (focus.dash_list);
@@ -2460,165 +2811,103 @@ murrine_style_draw_focus (GtkStyle *style, GdkWindow *window, GtkStateType state
 	cairo_destroy (cr);
 }
 
+/* Derives the options of a style from those of its rc style */
 static void
-murrine_style_init_from_rc (GtkStyle   *style,
-                            GtkRcStyle *rc_style)
+murrine_style_set_options (MurrineOptions       *options,
+                           const MurrineRcStyle *murrine_rc)
 {
-	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-
-	GTK_STYLE_CLASS (murrine_style_parent_class)->init_from_rc (style, rc_style);
+	memcpy (options, &murrine_rc->options, sizeof (MurrineOptions));
 
-	/* Shades/Colors/Ratio */
-	murrine_style->border_shades[0]   = MURRINE_RC_STYLE (rc_style)->border_shades[0];
-	murrine_style->border_shades[1]   = MURRINE_RC_STYLE (rc_style)->border_shades[1];
-	murrine_style->glow_shade         = MURRINE_RC_STYLE (rc_style)->glow_shade;
-	murrine_style->highlight_shade    = MURRINE_RC_STYLE (rc_style)->highlight_shade;
-	murrine_style->gradient_shades[0] = MURRINE_RC_STYLE (rc_style)->gradient_shades[0];
-	murrine_style->gradient_shades[1] = MURRINE_RC_STYLE (rc_style)->gradient_shades[1];
-	murrine_style->gradient_shades[2] = MURRINE_RC_STYLE (rc_style)->gradient_shades[2];
-	murrine_style->gradient_shades[3] = MURRINE_RC_STYLE (rc_style)->gradient_shades[3];
 	/* This is required to avoid glitches on different glazestyles */
-	if (MURRINE_RC_STYLE (rc_style)->glazestyle != 0)
+	if (options->glazestyle != 0)
 	{
-		double gradient_stop_mid = ((murrine_style->gradient_shades[1])+
-		                            (murrine_style->gradient_shades[2]))/2.0;
-		murrine_style->gradient_shades[1] = gradient_stop_mid;
-		murrine_style->gradient_shades[2] = gradient_stop_mid;
+		double gradient_stop_mid = ((options->gradient_shades[1])+
+		                            (options->gradient_shades[2]))/2.0;
+		options->gradient_shades[1] = gradient_stop_mid;
+		options->gradient_shades[2] = gradient_stop_mid;
 	}
 	/* Adjust lightborder_shade reading contrast */
-	murrine_style->lightborder_shade = murrine_get_contrast(MURRINE_RC_STYLE (rc_style)->lightborder_shade,
-	                                                        MURRINE_RC_STYLE (rc_style)->contrast);
-	murrine_style->shadow_shades[0]   = MURRINE_RC_STYLE (rc_style)->shadow_shades[0];
-	murrine_style->shadow_shades[1]   = MURRINE_RC_STYLE (rc_style)->shadow_shades[1];
-	murrine_style->trough_border_shades[0] = MURRINE_RC_STYLE (rc_style)->trough_border_shades[0];
-	murrine_style->trough_border_shades[1] = MURRINE_RC_STYLE (rc_style)->trough_border_shades[1];
-	murrine_style->trough_shades[0]   = MURRINE_RC_STYLE (rc_style)->trough_shades[0];
-	murrine_style->trough_shades[1]   = MURRINE_RC_STYLE (rc_style)->trough_shades[1];
-
-	/* Widget styles */
-	murrine_style->glazestyle         = MURRINE_RC_STYLE (rc_style)->glazestyle;
-	if (murrine_style->glazestyle == 2)
-	{
-		if (MURRINE_RC_STYLE (rc_style)->roundness > 0)
-			murrine_style->roundness = 1;
-		else
-			murrine_style->roundness = 0;
-	}
-	else
-		murrine_style->roundness = MURRINE_RC_STYLE (rc_style)->roundness;
-	murrine_style->animation           = MURRINE_RC_STYLE (rc_style)->animation;
-	murrine_style->arrowstyle          = MURRINE_RC_STYLE (rc_style)->arrowstyle;
-	murrine_style->cellstyle           = MURRINE_RC_STYLE (rc_style)->cellstyle;
-	murrine_style->comboboxstyle       = MURRINE_RC_STYLE (rc_style)->comboboxstyle;
-	murrine_style->contrast            = MURRINE_RC_STYLE (rc_style)->contrast;
-	murrine_style->colorize_scrollbar  = MURRINE_RC_STYLE (rc_style)->colorize_scrollbar;
-	murrine_style->expanderstyle       = MURRINE_RC_STYLE (rc_style)->expanderstyle;
-	murrine_style->focusstyle          = MURRINE_RC_STYLE (rc_style)->focusstyle;
-	murrine_style->glowstyle           = MURRINE_RC_STYLE (rc_style)->glowstyle;
-	murrine_style->has_border_colors   = MURRINE_RC_STYLE (rc_style)->has_border_colors;
-	murrine_style->has_default_button_color = MURRINE_RC_STYLE (rc_style)->flags & MRN_FLAG_DEFAULT_BUTTON_COLOR;
-	murrine_style->has_treeview_expander_color = MURRINE_RC_STYLE (rc_style)->has_treeview_expander_color;
-	murrine_style->has_focus_color     = MURRINE_RC_STYLE (rc_style)->flags & MRN_FLAG_FOCUS_COLOR;
-	murrine_style->has_gradient_colors = MURRINE_RC_STYLE (rc_style)->has_gradient_colors;
-	murrine_style->handlestyle         = MURRINE_RC_STYLE (rc_style)->handlestyle;
-	murrine_style->lightborderstyle    = MURRINE_RC_STYLE (rc_style)->lightborderstyle;
-	murrine_style->listviewheaderstyle = MURRINE_RC_STYLE (rc_style)->listviewheaderstyle;
-	murrine_style->listviewstyle       = MURRINE_RC_STYLE (rc_style)->listviewstyle;
-	murrine_style->menubarstyle        = MURRINE_RC_STYLE (rc_style)->menubarstyle;
-	murrine_style->menubaritemstyle    = MURRINE_RC_STYLE (rc_style)->menubaritemstyle;
-	murrine_style->menuitemstyle       = MURRINE_RC_STYLE (rc_style)->menuitemstyle;
-	murrine_style->menustyle           = MURRINE_RC_STYLE (rc_style)->menustyle;
-	murrine_style->prelight_shade      = MURRINE_RC_STYLE (rc_style)->prelight_shade;
-	murrine_style->progressbarstyle    = MURRINE_RC_STYLE (rc_style)->progressbarstyle;
-	murrine_style->reliefstyle         = MURRINE_RC_STYLE (rc_style)->reliefstyle;
-	murrine_style->rgba                = MURRINE_RC_STYLE (rc_style)->rgba;
-	murrine_style->scrollbarstyle      = MURRINE_RC_STYLE (rc_style)->scrollbarstyle;
-	murrine_style->separatorstyle      = MURRINE_RC_STYLE (rc_style)->separatorstyle;
-	murrine_style->sliderstyle         = MURRINE_RC_STYLE (rc_style)->sliderstyle;
-	murrine_style->spinbuttonstyle     = MURRINE_RC_STYLE (rc_style)->spinbuttonstyle;
-	murrine_style->stepperstyle        = MURRINE_RC_STYLE (rc_style)->stepperstyle;
-	murrine_style->textstyle           = MURRINE_RC_STYLE (rc_style)->textstyle;
-	murrine_style->text_shade          = MURRINE_RC_STYLE (rc_style)->text_shade;
-	murrine_style->toolbarstyle        = MURRINE_RC_STYLE (rc_style)->toolbarstyle;
-
-	if (murrine_style->has_border_colors)
-	{
-		murrine_style->border_colors[0] = MURRINE_RC_STYLE (rc_style)->border_colors[0];
-		murrine_style->border_colors[1] = MURRINE_RC_STYLE (rc_style)->border_colors[1];
-	}
-	if (murrine_style->has_default_button_color)
-		murrine_style->default_button_color = MURRINE_RC_STYLE (rc_style)->default_button_color;
-	if (murrine_style->has_treeview_expander_color)
-		murrine_style->treeview_expander_color = MURRINE_RC_STYLE (rc_style)->treeview_expander_color;
-	if (murrine_style->has_focus_color)
-		murrine_style->focus_color = MURRINE_RC_STYLE (rc_style)->focus_color;
-	if (murrine_style->has_gradient_colors)
-	{
-		murrine_style->gradient_colors[0] = MURRINE_RC_STYLE (rc_style)->gradient_colors[0];
-		murrine_style->gradient_colors[1] = MURRINE_RC_STYLE (rc_style)->gradient_colors[1];
-		murrine_style->gradient_colors[2] = MURRINE_RC_STYLE (rc_style)->gradient_colors[2];
-		murrine_style->gradient_colors[3] = MURRINE_RC_STYLE (rc_style)->gradient_colors[3];
-	}
+	options->lightborder_shade = murrine_get_contrast(options->lightborder_shade,
+	                                                  options->contrast);
+
+	if (options->glazestyle == 2)
+		options->roundness = options->roundness > 0 ? 1 : 0;
 }
 
 static void
-murrine_style_realize (GtkStyle *style)
+murrine_style_init_from_rc (GtkStyle   *style,
+                            GtkRcStyle *rc_style)
 {
-	MurrineStyle *murrine_style = MURRINE_STYLE (style);
-	double shades[] = {1.065, 0.95, 0.896, 0.82, 0.75, 0.665, 0.5, 0.45, 0.4};
-	double spots[] = {1.42, 1.00, 0.65};
-	MurrineRGB spot_color;
-	MurrineRGB bg_normal;
-	double contrast;
-	int i;
+	gint64 start = murrine_profile_begin ();
 
-	GTK_STYLE_CLASS (murrine_style_parent_class)->realize (style);
+	GTK_STYLE_CLASS (murrine_style_parent_class)->init_from_rc (style, rc_style);
 
-	contrast = MURRINE_RC_STYLE (style->rc_style)->contrast;
+	murrine_style_set_options (&MURRINE_STYLE (style)->options, MURRINE_RC_STYLE (rc_style));
 
-	bg_normal.r = style->bg[0].red/65535.0;
-	bg_normal.g = style->bg[0].green/65535.0;
-	bg_normal.b = style->bg[0].blue/65535.0;
+	murrine_profile_end (MRN_PROFILE_STYLE_INIT_FROM_RC, start);
+}
 
-	/* Apply contrast */
-	for (i = 0; i < 9; i++)
-	{
-		murrine_shade (&bg_normal,
-		               murrine_get_contrast(shades[i], contrast),
-		               &murrine_style->colors.shade[i]);
-	}
-	spots[2] = murrine_get_contrast(spots[2], contrast);
+/* Redraws the widgets drawn with one of the changed styles */
+static void
+murrine_style_queue_draw_changed (GtkWidget *widget, gpointer data)
+{
+	GHashTable *changed = data;
 
-	spot_color.r = style->bg[GTK_STATE_SELECTED].red/65535.0;
-	spot_color.g = style->bg[GTK_STATE_SELECTED].green/65535.0;
-	spot_color.b = style->bg[GTK_STATE_SELECTED].blue/65535.0;
+	if (g_hash_table_lookup (changed, widget->style))
+		gtk_widget_queue_draw (widget);
 
-	murrine_shade (&spot_color, spots[0], &murrine_style->colors.spot[0]);
-	murrine_shade (&spot_color, spots[1], &murrine_style->colors.spot[1]);
-	murrine_shade (&spot_color, spots[2], &murrine_style->colors.spot[2]);
+	if (GTK_IS_CONTAINER (widget))
+		gtk_container_forall (GTK_CONTAINER (widget), murrine_style_queue_draw_changed, changed);
+}
 
-	for (i=0; i<5; i++)
+/* Called by murrine_rc_style_reload () once the options of the rc styles
+ * are updated. Styles keep their palette unless their options changed,
+ * only the widgets using a changed style are redrawn. */
+void
+murrine_style_reload (void)
+{
+	GHashTable *changed = NULL;
+	GSList *l;
+	GList *toplevels;
+
+	for (l = styles; l; l = l->next)
 	{
-		murrine_gdk_color_to_rgb (&style->bg[i],
-		                          &murrine_style->colors.bg[i].r,
-		                          &murrine_style->colors.bg[i].g,
-		                          &murrine_style->colors.bg[i].b);
+		MurrineStyle *murrine_style = l->data;
+		GtkRcStyle *rc_style = GTK_STYLE (murrine_style)->rc_style;
+		MurrineOptions options;
+
+		if (rc_style == NULL || !MURRINE_IS_RC_STYLE (rc_style))
+			continue;
 
-		murrine_gdk_color_to_rgb (&style->base[i],
-		                          &murrine_style->colors.base[i].r,
-		                          &murrine_style->colors.base[i].g,
-		                          &murrine_style->colors.base[i].b);
+		murrine_style_set_options (&options, MURRINE_RC_STYLE (rc_style));
+		if (memcmp (&options, &murrine_style->options, sizeof (MurrineOptions)) == 0)
+			continue;
 
-		murrine_gdk_color_to_rgb (&style->text[i],
-		                          &murrine_style->colors.text[i].r,
-		                          &murrine_style->colors.text[i].g,
-		                          &murrine_style->colors.text[i].b);
+		memcpy (&murrine_style->options, &options, sizeof (MurrineOptions));
+		murrine_style_clear_caches (murrine_style);
 
-		murrine_gdk_color_to_rgb (&style->fg[i],
-		                          &murrine_style->colors.fg[i].r,
-		                          &murrine_style->colors.fg[i].g,
-		                          &murrine_style->colors.fg[i].b);
+		if (!changed)
+			changed = g_hash_table_new (g_direct_hash, g_direct_equal);
+		g_hash_table_insert (changed, murrine_style, murrine_style);
 	}
+
+	if (!changed)
+		return;
+
+	toplevels = gtk_window_list_toplevels ();
+	g_list_foreach (toplevels, (GFunc) murrine_style_queue_draw_changed, changed);
+	g_list_free (toplevels);
+
+	g_hash_table_destroy (changed);
+}
+
+static void
+murrine_style_realize (GtkStyle *style)
+{
+	GTK_STYLE_CLASS (murrine_style_parent_class)->realize (style);
+
+	/* The palette is computed lazily by murrine_style_get_colors () */
+	murrine_style_clear_caches (MURRINE_STYLE (style));
 }
 
 static void
@@ -2642,67 +2931,10 @@ murrine_style_copy (GtkStyle *style, GtkStyle *src)
 	MurrineStyle *mrn_style = MURRINE_STYLE (style);
 	MurrineStyle *mrn_src = MURRINE_STYLE (src);
 
-	mrn_style->animation           = mrn_src->animation;
-	mrn_style->arrowstyle          = mrn_src->arrowstyle;
-	mrn_style->border_colors[0]    = mrn_src->border_colors[0];
-	mrn_style->border_colors[1]    = mrn_src->border_colors[1];
-	mrn_style->border_shades[0]    = mrn_src->border_shades[0];
-	mrn_style->border_shades[1]    = mrn_src->border_shades[1];
-	mrn_style->cellstyle           = mrn_src->cellstyle;
-	mrn_style->colorize_scrollbar  = mrn_src->colorize_scrollbar;
-	mrn_style->colors              = mrn_src->colors;
-	mrn_style->comboboxstyle       = mrn_src->comboboxstyle;
-	mrn_style->contrast            = mrn_src->contrast;
-	mrn_style->default_button_color = mrn_src->default_button_color;
-	mrn_style->expanderstyle       = mrn_src->expanderstyle;
-	mrn_style->focusstyle          = mrn_src->focusstyle;
-	mrn_style->focus_color         = mrn_src->focus_color;
-	mrn_style->glazestyle          = mrn_src->glazestyle;
-	mrn_style->glow_shade          = mrn_src->glow_shade;
-	mrn_style->glowstyle           = mrn_src->glowstyle;
-	mrn_style->gradient_colors[0]  = mrn_src->gradient_colors[0];
-	mrn_style->gradient_colors[1]  = mrn_src->gradient_colors[1];
-	mrn_style->gradient_colors[2]  = mrn_src->gradient_colors[2];
-	mrn_style->gradient_colors[3]  = mrn_src->gradient_colors[3];
-	mrn_style->gradient_shades[0]  = mrn_src->gradient_shades[0];
-	mrn_style->gradient_shades[1]  = mrn_src->gradient_shades[1];
-	mrn_style->gradient_shades[2]  = mrn_src->gradient_shades[2];
-	mrn_style->gradient_shades[3]  = mrn_src->gradient_shades[3];
-	mrn_style->handlestyle         = mrn_src->handlestyle;
-	mrn_style->has_border_colors   = mrn_src->has_border_colors;
-	mrn_style->has_default_button_color = mrn_src->has_default_button_color;
-	mrn_style->has_focus_color     = mrn_src->has_focus_color;
-	mrn_style->has_gradient_colors = mrn_src->has_gradient_colors;
-	mrn_style->has_treeview_expander_color = mrn_src->has_treeview_expander_color;
-	mrn_style->highlight_shade     = mrn_src->highlight_shade;
-	mrn_style->lightborder_shade   = mrn_src->lightborder_shade;
-	mrn_style->lightborderstyle    = mrn_src->lightborderstyle;
-	mrn_style->listviewheaderstyle = mrn_src->listviewheaderstyle;
-	mrn_style->listviewstyle       = mrn_src->listviewstyle;
-	mrn_style->menubaritemstyle    = mrn_src->menubaritemstyle;
-	mrn_style->menubarstyle        = mrn_src->menubarstyle;
-	mrn_style->menuitemstyle       = mrn_src->menuitemstyle;
-	mrn_style->menustyle           = mrn_src->menustyle;
-	mrn_style->prelight_shade      = mrn_src->prelight_shade;
-	mrn_style->progressbarstyle    = mrn_src->progressbarstyle;
-	mrn_style->reliefstyle         = mrn_src->reliefstyle;
-	mrn_style->rgba                = mrn_src->rgba;
-	mrn_style->roundness           = mrn_src->roundness;
-	mrn_style->scrollbarstyle      = mrn_src->scrollbarstyle;
-	mrn_style->separatorstyle      = mrn_src->separatorstyle;
-	mrn_style->shadow_shades[0]    = mrn_src->shadow_shades[0];
-	mrn_style->shadow_shades[1]    = mrn_src->shadow_shades[1];
-	mrn_style->sliderstyle 	       = mrn_src->sliderstyle;
-	mrn_style->spinbuttonstyle     = mrn_src->spinbuttonstyle;
-	mrn_style->stepperstyle        = mrn_src->stepperstyle;
-	mrn_style->textstyle           = mrn_src->textstyle;
-	mrn_style->text_shade          = mrn_src->text_shade;
-	mrn_style->toolbarstyle        = mrn_src->toolbarstyle;
-	mrn_style->treeview_expander_color = mrn_src->treeview_expander_color;
-	mrn_style->trough_border_shades[0] = mrn_src->trough_border_shades[0];
-	mrn_style->trough_border_shades[1] = mrn_src->trough_border_shades[1];
-	mrn_style->trough_shades[0]    = mrn_src->trough_shades[0];
-	mrn_style->trough_shades[1]    = mrn_src->trough_shades[1];
+	mrn_style->options = mrn_src->options;
+
+	/* The palette is derived again from the copied colors when needed */
+	murrine_style_clear_caches (mrn_style);
 
 	GTK_STYLE_CLASS (murrine_style_parent_class)->copy (style, src);
 }
@@ -2710,9 +2942,21 @@ murrine_style_copy (GtkStyle *style, GtkStyle *src)
 static void
 murrine_style_unrealize (GtkStyle *style)
 {
+	murrine_style_clear_caches (MURRINE_STYLE (style));
+
 	GTK_STYLE_CLASS (murrine_style_parent_class)->unrealize (style);
 }
 
+static void
+murrine_style_finalize (GObject *object)
+{
+	styles = g_slist_remove (styles, object);
+
+	murrine_style_clear_caches (MURRINE_STYLE (object));
+
+	G_OBJECT_CLASS (murrine_style_parent_class)->finalize (object);
+}
+
 static GdkPixbuf *
 set_transparency (const GdkPixbuf *pixbuf, gdouble alpha_percent)
 {
@@ -2871,12 +3115,16 @@ murrine_style_register_types (GTypeModule *module)
 static void
 murrine_style_init (MurrineStyle *style)
 {
+	styles = g_slist_prepend (styles, style);
 }
 
 static void
 murrine_style_class_init (MurrineStyleClass *klass)
 {
 	GtkStyleClass *style_class = GTK_STYLE_CLASS (klass);
+	GObjectClass  *g_object_class = G_OBJECT_CLASS (klass);
+
+	g_object_class->finalize = murrine_style_finalize;
 
 	style_class->copy             = murrine_style_copy;
 	style_class->realize          = murrine_style_realize;
@@ -2905,6 +3153,8 @@ murrine_style_class_init (MurrineStyleClass *klass)
 	murrine_register_style_murrine (&klass->style_functions[MRN_STYLE_MURRINE]);
 	klass->style_functions[MRN_STYLE_RGBA] = klass->style_functions[MRN_STYLE_MURRINE];
 	murrine_register_style_rgba (&klass->style_functions[MRN_STYLE_RGBA]);
+
+	murrine_draw_profile_install (style_class, klass->style_functions);
 }
 
 static void
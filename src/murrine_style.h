@@ -25,6 +25,7 @@
 
 #include "animation.h"
 #include "murrine_types.h"
+#include "palette.h"
 
 typedef struct _MurrineStyle MurrineStyle;
 typedef struct _MurrineStyleClass MurrineStyleClass;
@@ -42,60 +43,8 @@ struct _MurrineStyle
 {
 	GtkStyle parent_instance;
 
-	MurrineColors colors;
-
-	double   border_shades[2];
-	double   contrast;
-	double   glow_shade;
-	double   gradient_shades[4];
-	double   highlight_shade;
-	double   lightborder_shade;
-	double   prelight_shade;
-	double   shadow_shades[2];
-	double   text_shade;
-	double   trough_border_shades[2];
-	double   trough_shades[2];
-
-	guint8   arrowstyle;
-	guint8   cellstyle;
-	guint8   comboboxstyle;
-	guint8   expanderstyle;
-	guint8   focusstyle;
-	guint8   glazestyle;
-	guint8   glowstyle;
-	guint8   handlestyle;
-	guint8   lightborderstyle;
-	guint8   listviewheaderstyle;
-	guint8   listviewstyle;
-	guint8   menubaritemstyle;
-	guint8   menubarstyle;
-	guint8   menuitemstyle;
-	guint8   menustyle;
-	guint8   progressbarstyle;
-	guint8   reliefstyle;
-	guint8   roundness;
-	guint8   scrollbarstyle;
-	guint8   separatorstyle;
-	guint8   sliderstyle;
-	guint8   spinbuttonstyle;
-	guint8   stepperstyle;
-	guint8   textstyle;
-	guint8   toolbarstyle;
-
-	gboolean animation;
-	gboolean colorize_scrollbar;
-	gboolean has_border_colors;
-	gboolean has_default_button_color;
-	gboolean has_focus_color;
-	gboolean has_gradient_colors;
-	gboolean rgba;
-	gboolean has_treeview_expander_color;
-
-	GdkColor border_colors[2];
-	GdkColor default_button_color;
-	GdkColor focus_color;
-	GdkColor gradient_colors[4];
-	GdkColor treeview_expander_color;
+	MurrineOptions  options;
+	MurrinePalette *palette;
 };
 
 struct _MurrineStyleClass
@@ -107,4 +56,6 @@ struct _MurrineStyleClass
 
 GType murrine_style_get_type (void);
 
+G_GNUC_INTERNAL void murrine_style_reload (void);
+
 #endif /* MURRINE_STYLE_H */
@@ -23,18 +23,109 @@
 
 #include "murrine_style.h"
 #include "murrine_rc_style.h"
+#include "draw-profile.h"
+#include "frame-cache.h"
+#include "profile.h"
+#include "raster-cache.h"
+#include "rc-cache.h"
+#include "rc-watch.h"
 
 G_MODULE_EXPORT void
 theme_init (GTypeModule *module)
 {
+	gint64 start = murrine_profile_begin ();
+
 //	printf ("Murrine 0.91.x Development Snapshot, Copyright Andrea Cimitan\n"); 
 	murrine_rc_style_register_types (module);
 	murrine_style_register_types (module);
+
+	murrine_profile_end (MRN_PROFILE_THEME_INIT, start);
 }
 
 G_MODULE_EXPORT void
 theme_exit (void)
 {
+	/* Nothing of ours may outlive the module: timers and signal handlers
+	 * would call into unloaded code, cached surfaces would leak on every
+	 * theme switch. Per-style caches go away with their styles. */
+#ifdef HAVE_ANIMATION
+	murrine_animation_cleanup ();
+#endif
+	murrine_draw_profile_shutdown ();
+	murrine_frame_cache_shutdown ();
+	murrine_raster_cache_clear ();
+	murrine_rc_cache_shutdown ();
+	murrine_rc_watch_shutdown ();
+}
+
+/* Reports the cost of painting animation frames, in microseconds, so that
+ * it can be monitored: the moving average and the peak, the budget they
+ * are held against and how far animations have been degraded to meet it
+ * (0 for not at all). Everything is 0 without animation support. */
+G_MODULE_EXPORT void
+theme_get_animation_stats (gint64 *frame_cost, gint64 *peak_cost,
+                           gint64 *budget, gint *level)
+{
+#ifdef HAVE_ANIMATION
+	murrine_animation_get_stats (frame_cost, peak_cost, budget, level);
+#else
+	if (frame_cost)
+		*frame_cost = 0;
+	if (peak_cost)
+		*peak_cost = 0;
+	if (budget)
+		*budget = 0;
+	if (level)
+		*level = 0;
+#endif
+}
+
+/* Step animations under XAMARIN_ANIMATION_CLOCK=virtual, e.g. to render
+ * every frame of a fade at exact timestamps. The time is in microseconds,
+ * FALSE is returned when the animations follow the real clock. They have
+ * to be called from the thread running gtk. */
+G_MODULE_EXPORT gboolean
+theme_set_animation_clock (gint64 time)
+{
+#ifdef HAVE_ANIMATION
+	return murrine_animation_set_clock (time);
+#else
+	return FALSE;
+#endif
+}
+
+G_MODULE_EXPORT gboolean
+theme_advance_animation_clock (gint64 delta)
+{
+#ifdef HAVE_ANIMATION
+	return murrine_animation_advance_clock (delta);
+#else
+	return FALSE;
+#endif
+}
+
+/* Reads the engine options from the gtkrc files again and repaints with
+ * them, cheaper than gtk_rc_reparse_all () when only those changed.
+ * Returns TRUE if any option changed. Set XAMARIN_THEME_WATCH to have it
+ * called whenever a gtkrc is saved. */
+G_MODULE_EXPORT gboolean
+theme_reload_options (void)
+{
+	return murrine_rc_style_reload ();
+}
+
+/* Statistics of the drawing functions under XAMARIN_DRAW_PROFILE, see
+ * MurrineDrawStats. They have to be called from the thread running gtk. */
+G_MODULE_EXPORT void
+theme_foreach_draw_stats (MurrineDrawStatsFunc func, gpointer user_data)
+{
+	murrine_draw_profile_foreach (func, user_data);
+}
+
+G_MODULE_EXPORT void
+theme_reset_draw_stats (void)
+{
+	murrine_draw_profile_reset ();
 }
 
 G_MODULE_EXPORT GtkRcStyle *
@@ -51,6 +142,8 @@ G_MODULE_EXPORT const gchar* g_module_check_init (GModule *module);
 const gchar*
 g_module_check_init (GModule *module)
 {
+	murrine_profile_init (module);
+
 	return gtk_check_version (GTK_MAJOR_VERSION,
 	                          GTK_MINOR_VERSION,
 	                          GTK_MICRO_VERSION - GTK_INTERFACE_AGE);
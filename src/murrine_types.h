@@ -32,6 +32,74 @@ typedef enum
 	MRN_NUM_DRAW_STYLES = 2
 } MurrineStyles;
 
+typedef enum
+{
+	MRN_TRANSITION_PRELIGHT,
+	MRN_TRANSITION_ACTIVE,
+	MRN_TRANSITION_FOCUS,
+	MRN_TRANSITION_SLIDER,
+	MRN_NUM_TRANSITIONS
+} MurrineTransitionType;
+
+/* The engine options, one block in both the rc style and the style so
+ * that they are copied at once */
+typedef struct
+{
+	double   border_shades[2];
+	double   contrast;
+	double   glow_shade;
+	double   gradient_shades[4];
+	double   highlight_shade;
+	double   lightborder_shade;
+	double   prelight_shade;
+	double   shadow_shades[2];
+	double   text_shade;
+	double   trough_border_shades[2];
+	double   trough_shades[2];
+	double   transition_durations[MRN_NUM_TRANSITIONS];
+
+	guint8   arrowstyle;
+	guint8   cellstyle;
+	guint8   comboboxstyle;
+	guint8   expanderstyle;
+	guint8   focusstyle;
+	guint8   glazestyle;
+	guint8   glowstyle;
+	guint8   handlestyle;
+	guint8   lightborderstyle;
+	guint8   listviewheaderstyle;
+	guint8   listviewstyle;
+	guint8   menubaritemstyle;
+	guint8   menubarstyle;
+	guint8   menuitemstyle;
+	guint8   menustyle;
+	guint8   progressbarstyle;
+	guint8   reliefstyle;
+	guint8   roundness;
+	guint8   scrollbarstyle;
+	guint8   separatorstyle;
+	guint8   sliderstyle;
+	guint8   spinbuttonstyle;
+	guint8   stepperstyle;
+	guint8   textstyle;
+	guint8   toolbarstyle;
+
+	gboolean animation;
+	gboolean colorize_scrollbar;
+	gboolean has_border_colors;
+	gboolean has_default_button_color;
+	gboolean has_focus_color;
+	gboolean has_gradient_colors;
+	gboolean has_treeview_expander_color;
+	gboolean rgba;
+
+	GdkColor border_colors[2];
+	GdkColor default_button_color;
+	GdkColor focus_color;
+	GdkColor gradient_colors[4];
+	GdkColor treeview_expander_color;
+} MurrineOptions;
+
 typedef enum
 {
 	MRN_STATE_NORMAL,
@@ -0,0 +1,221 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <string.h>
+
+#include "palette.h"
+#include "cairo-support.h"
+#include "profile.h"
+#include "support.h"
+#include "trace.h"
+
+static GHashTable *palettes = NULL;
+static GHashTable *ladders = NULL;
+
+/* The options come from zero-filled objects and are copied whole, so
+ * their padding compares equal along with the fields. */
+MRN_DEFINE_KEY_HASH (murrine_palette_key, MurrinePaletteKey)
+MRN_DEFINE_KEY_HASH (murrine_ladder_key, MurrineLadderKey)
+
+static void
+murrine_palette_key_color (const GdkColor *color, guint16 *rgb)
+{
+	rgb[0] = color->red;
+	rgb[1] = color->green;
+	rgb[2] = color->blue;
+}
+
+static void
+murrine_palette_rgb (const guint16 *rgb, MurrineRGB *color)
+{
+	color->r = rgb[0]/65535.0;
+	color->g = rgb[1]/65535.0;
+	color->b = rgb[2]/65535.0;
+}
+
+static MurrineShadeLadder *
+murrine_ladder_lookup (const MurrinePaletteKey *palette_key)
+{
+	double shades[] = {1.065, 0.95, 0.896, 0.82, 0.75, 0.665, 0.5, 0.45, 0.4};
+	double spots[] = {1.42, 1.00, 0.65};
+	MurrineLadderKey key;
+	MurrineShadeLadder *ladder;
+	MurrineRGB bg_normal, spot_color;
+	int i;
+
+	memset (&key, 0, sizeof (key));
+	memcpy (key.bg, palette_key->bg[GTK_STATE_NORMAL], sizeof (key.bg));
+	memcpy (key.selected, palette_key->bg[GTK_STATE_SELECTED], sizeof (key.selected));
+	key.contrast = palette_key->options.contrast;
+
+	if (ladders == NULL)
+		ladders = g_hash_table_new (murrine_ladder_key_hash, murrine_ladder_key_equal);
+
+	ladder = g_hash_table_lookup (ladders, &key);
+	if (ladder)
+	{
+		ladder->ref_count++;
+		return ladder;
+	}
+
+	MRN_TRACE_CACHE_MISS ("ladder", 0, 0);
+
+	ladder = g_new (MurrineShadeLadder, 1);
+	ladder->ref_count = 1;
+	ladder->key = key;
+
+	murrine_palette_rgb (key.bg, &bg_normal);
+
+	/* Apply contrast */
+	for (i = 0; i < 9; i++)
+	{
+		murrine_shade (&bg_normal,
+		               murrine_get_contrast(shades[i], key.contrast),
+		               &ladder->shade[i]);
+	}
+
+	spots[2] = murrine_get_contrast(spots[2], key.contrast);
+
+	murrine_palette_rgb (key.selected, &spot_color);
+
+	murrine_shade (&spot_color, spots[0], &ladder->spot[0]);
+	murrine_shade (&spot_color, spots[1], &ladder->spot[1]);
+	murrine_shade (&spot_color, spots[2], &ladder->spot[2]);
+
+	g_hash_table_insert (ladders, &ladder->key, ladder);
+
+	MRN_TRACE_CACHE_FILL ("ladder");
+
+	return ladder;
+}
+
+static void
+murrine_ladder_unref (MurrineShadeLadder *ladder)
+{
+	if (--ladder->ref_count > 0)
+		return;
+
+	g_hash_table_remove (ladders, &ladder->key);
+	if (g_hash_table_size (ladders) == 0)
+	{
+		g_hash_table_destroy (ladders);
+		ladders = NULL;
+	}
+
+	g_free (ladder);
+}
+
+/* Returns a reference to the palette of a style with these options and
+ * colors, creating it if no other style uses it yet. */
+MurrinePalette *
+murrine_palette_lookup (const MurrineOptions *options, const GtkStyle *style)
+{
+	MurrinePaletteKey key;
+	MurrinePalette *palette;
+	int i;
+
+	memset (&key, 0, sizeof (key));
+	memcpy (&key.options, options, sizeof (MurrineOptions));
+
+	for (i = 0; i < 5; i++)
+	{
+		murrine_palette_key_color (&style->bg[i], key.bg[i]);
+		murrine_palette_key_color (&style->base[i], key.base[i]);
+		murrine_palette_key_color (&style->text[i], key.text[i]);
+		murrine_palette_key_color (&style->fg[i], key.fg[i]);
+	}
+
+	if (palettes == NULL)
+		palettes = g_hash_table_new (murrine_palette_key_hash, murrine_palette_key_equal);
+
+	palette = g_hash_table_lookup (palettes, &key);
+	if (palette)
+	{
+		palette->ref_count++;
+		return palette;
+	}
+
+	palette = g_new0 (MurrinePalette, 1);
+	palette->ref_count = 1;
+	palette->key = key;
+
+	g_hash_table_insert (palettes, &palette->key, palette);
+
+	return palette;
+}
+
+void
+murrine_palette_unref (MurrinePalette *palette)
+{
+	if (--palette->ref_count > 0)
+		return;
+
+	g_hash_table_remove (palettes, &palette->key);
+	if (g_hash_table_size (palettes) == 0)
+	{
+		g_hash_table_destroy (palettes);
+		palettes = NULL;
+	}
+
+	if (palette->row_stripes)
+		g_hash_table_destroy (palette->row_stripes);
+	if (palette->display_lists)
+		murrine_display_lists_free (palette->display_lists);
+	if (palette->frame_cache)
+		murrine_frame_cache_unref (palette->frame_cache);
+	if (palette->ladder)
+		murrine_ladder_unref (palette->ladder);
+
+	g_free (palette);
+}
+
+/* Returns the colors of the palette, computing them the first time
+ * a style using it is painted. */
+MurrineColors *
+murrine_palette_get_colors (MurrinePalette *palette)
+{
+	const MurrinePaletteKey *key = &palette->key;
+	MurrineColors *colors = &palette->colors;
+	gint64 start;
+	int i;
+
+	if (palette->colors_valid)
+		return colors;
+
+	start = murrine_profile_begin ();
+
+	palette->ladder = murrine_ladder_lookup (key);
+	memcpy (colors->shade, palette->ladder->shade, sizeof (colors->shade));
+	memcpy (colors->spot, palette->ladder->spot, sizeof (colors->spot));
+
+	for (i=0; i<5; i++)
+	{
+		murrine_palette_rgb (key->bg[i], &colors->bg[i]);
+		murrine_palette_rgb (key->base[i], &colors->base[i]);
+		murrine_palette_rgb (key->text[i], &colors->text[i]);
+		murrine_palette_rgb (key->fg[i], &colors->fg[i]);
+	}
+
+	palette->colors_valid = TRUE;
+
+	murrine_profile_end (MRN_PROFILE_STYLE_PALETTE, start);
+
+	return colors;
+}
@@ -0,0 +1,84 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <gtk/gtk.h>
+
+#include "display-list.h"
+#include "frame-cache.h"
+#include "murrine_types.h"
+
+/* Everything the palette and the caches below are derived from. The
+ * GtkStyle colors are reduced to their components, the pixel values
+ * depend on the colormap and do not change the output. */
+typedef struct
+{
+	MurrineOptions options;
+	guint16        bg[5][3];
+	guint16        base[5][3];
+	guint16        text[5][3];
+	guint16        fg[5][3];
+} MurrinePaletteKey;
+
+/* The shades and spots only depend on the normal and selected bg colors
+ * and on the contrast, which many palettes have in common: they share
+ * one ladder and copy it. */
+typedef struct
+{
+	guint16 bg[3];
+	guint16 selected[3];
+	double  contrast;
+} MurrineLadderKey;
+
+typedef struct
+{
+	guint            ref_count;
+	MurrineLadderKey key;
+
+	MurrineRGB shade[9];
+	MurrineRGB spot[3];
+} MurrineShadeLadder;
+
+/* Styles resolving to the same key share one palette, interned by the
+ * hash of its key, along with the caches of what they drew with it. */
+typedef struct
+{
+	guint             ref_count;
+	MurrinePaletteKey key;
+
+	MurrineColors       colors;
+	gboolean            colors_valid;
+	MurrineShadeLadder *ladder;
+
+	GHashTable          *row_stripes;
+	MurrineDisplayLists *display_lists;
+	MurrineFrameCache   *frame_cache;
+} MurrinePalette;
+
+G_GNUC_INTERNAL MurrinePalette *murrine_palette_lookup (const MurrineOptions *options,
+                                                        const GtkStyle       *style);
+
+G_GNUC_INTERNAL void murrine_palette_unref (MurrinePalette *palette);
+
+G_GNUC_INTERNAL MurrineColors *murrine_palette_get_colors (MurrinePalette *palette);
+
+#endif /* PALETTE_H */
@@ -0,0 +1,165 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "profile.h"
+
+typedef struct
+{
+	const gchar *name;
+	guint64      calls;
+	guint64      nsec;
+} ProfileCounter;
+
+static gboolean profile_enabled = FALSE;
+
+static ProfileCounter profile_counters[MRN_PROFILE_NUM_PHASES] =
+{
+	{ "theme_init", 0, 0 },
+	{ "rc_style_parse", 0, 0 },
+	{ "style_init_from_rc", 0, 0 },
+	{ "style_palette", 0, 0 }
+};
+
+gint64
+murrine_profile_now (void)
+{
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+
+	return (gint64) ts.tv_sec * G_GINT64_CONSTANT (1000000000) + ts.tv_nsec;
+}
+
+/* The summary is also written from the signal handler, so it is put
+ * together by hand and written with write () */
+static gchar *
+profile_append (gchar *p, const gchar *str)
+{
+	while (*str)
+		*p++ = *str++;
+
+	return p;
+}
+
+static gchar *
+profile_append_uint (gchar *p, guint64 value, guint width)
+{
+	gchar digits[24];
+	guint n = 0;
+
+	do
+	{
+		digits[n++] = '0' + value % 10;
+		value /= 10;
+	}
+	while (value > 0);
+
+	for (; width > n; width--)
+		*p++ = ' ';
+	while (n > 0)
+		*p++ = digits[--n];
+
+	return p;
+}
+
+static void
+profile_dump (void)
+{
+	gchar buffer[128];
+	guint i;
+
+	for (i = 0; i < MRN_PROFILE_NUM_PHASES; i++)
+	{
+		const ProfileCounter *counter = &profile_counters[i];
+		gchar *p = buffer;
+		guint pad;
+
+		p = profile_append (p, "xamarin-profile: ");
+		p = profile_append (p, counter->name);
+		for (pad = strlen (counter->name); pad < 20; pad++)
+			*p++ = ' ';
+		p = profile_append_uint (p, counter->calls, 8);
+		p = profile_append (p, " calls ");
+		p = profile_append_uint (p, counter->nsec, 14);
+		p = profile_append (p, " ns\n");
+
+		if (write (STDERR_FILENO, buffer, p - buffer) < 0)
+			return;
+	}
+}
+
+static void
+profile_signal_handler (int signum)
+{
+	profile_dump ();
+}
+
+/* Called when the module is loaded. Profiling keeps the module resident,
+ * since the summary is printed by an atexit handler. SIGUSR2 is only
+ * taken when the application left it alone, Mono for one uses it. */
+void
+murrine_profile_init (GModule *module)
+{
+	const gchar *env = g_getenv ("XAMARIN_THEME_PROFILE");
+	struct sigaction action;
+
+	if (profile_enabled || !env || !*env || strcmp (env, "0") == 0)
+		return;
+
+	profile_enabled = TRUE;
+
+	g_module_make_resident (module);
+	atexit (profile_dump);
+
+	if (sigaction (SIGUSR2, NULL, &action) == 0 &&
+	    !(action.sa_flags & SA_SIGINFO) && action.sa_handler == SIG_DFL)
+	{
+		memset (&action, 0, sizeof (action));
+		action.sa_handler = profile_signal_handler;
+		action.sa_flags = SA_RESTART;
+		sigemptyset (&action.sa_mask);
+		sigaction (SIGUSR2, &action, NULL);
+	}
+}
+
+gint64
+murrine_profile_begin (void)
+{
+	if (!profile_enabled)
+		return 0;
+
+	return murrine_profile_now ();
+}
+
+void
+murrine_profile_end (MurrineProfilePhase phase, gint64 start)
+{
+	if (start == 0)
+		return;
+
+	profile_counters[phase].calls++;
+	profile_counters[phase].nsec += murrine_profile_now () - start;
+}
@@ -0,0 +1,48 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <gmodule.h>
+
+/* Startup phases timed with XAMARIN_THEME_PROFILE set. The call counts
+ * and nanoseconds spent are printed on stderr at exit, and on SIGUSR2
+ * unless the application handles that signal itself. */
+typedef enum
+{
+	MRN_PROFILE_THEME_INIT,
+	MRN_PROFILE_RC_STYLE_PARSE,
+	MRN_PROFILE_STYLE_INIT_FROM_RC,
+	MRN_PROFILE_STYLE_PALETTE, /* first use of each palette, realize is lazy */
+	MRN_PROFILE_NUM_PHASES
+} MurrineProfilePhase;
+
+G_GNUC_INTERNAL void murrine_profile_init (GModule *module);
+
+/* Monotonic time in nanoseconds */
+G_GNUC_INTERNAL gint64 murrine_profile_now (void);
+
+/* Returns the time to pass to murrine_profile_end (), 0 when disabled */
+G_GNUC_INTERNAL gint64 murrine_profile_begin (void);
+
+G_GNUC_INTERNAL void murrine_profile_end (MurrineProfilePhase phase, gint64 start);
+
+#endif /* PROFILE_H */
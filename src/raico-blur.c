@@ -27,6 +27,7 @@
 #include "exponential-blur.h"
 #include "stack-blur.h"
 #include "gaussian-blur.h"
+#include "trace.h"
 
 struct _raico_blur_private_t
 {
@@ -149,6 +150,11 @@ raico_blur_apply (raico_blur_t*    blur,
 	if (blur->priv->radius == 0)
 		return;
 
+	if (MRN_TRACE_BLUR_BEGIN_ENABLED ())
+		MRN_TRACE_BLUR_BEGIN (cairo_image_surface_get_width (surface),
+		                      cairo_image_surface_get_height (surface),
+		                      blur->priv->radius);
+
 	// now do the real work
 	switch (blur->priv->quality)
 	{
@@ -165,6 +171,8 @@ raico_blur_apply (raico_blur_t*    blur,
 			surface_gaussian_blur (surface, blur->priv->radius);
 		break;
 	}
+
+	MRN_TRACE_BLUR_END ();
 }
 
 void
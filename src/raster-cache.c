@@ -0,0 +1,170 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "raster-cache.h"
+#include "support.h"
+#include "trace.h"
+
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 14, 0)
+#define HAVE_DEVICE_SCALE 1
+#endif
+
+/* Upper bound of the pixels kept alive by the cache, 16MB of ARGB32 */
+#define RASTER_CACHE_MAX_PIXELS (4 * 1024 * 1024)
+
+/* Frames may be rendered off the main thread, see frame-cache.c */
+G_LOCK_DEFINE_STATIC (raster_cache);
+
+static GHashTable *raster_cache = NULL;
+static gsize raster_cache_pixels = 0;
+
+static gsize
+raster_surface_pixels (cairo_surface_t *surface)
+{
+	return (gsize)cairo_image_surface_get_width (surface) *
+	       cairo_image_surface_get_height (surface);
+}
+
+double
+murrine_get_device_scale (cairo_t *cr)
+{
+#ifdef HAVE_DEVICE_SCALE
+	double x_scale, y_scale;
+
+	/* the group being drawn to inside cairo_push_group () */
+	cairo_surface_get_device_scale (cairo_get_group_target (cr), &x_scale, &y_scale);
+
+	return MAX (x_scale, y_scale);
+#else
+	return 1.0;
+#endif
+}
+
+/* Creates an image surface covering width x height user units at the
+ * given scale. Drawing on it is done in user units. */
+cairo_surface_t*
+murrine_raster_surface_create (int width, int height, double scale)
+{
+	cairo_surface_t *surface;
+
+	surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+	                                      (int)ceil (width*scale),
+	                                      (int)ceil (height*scale));
+#ifdef HAVE_DEVICE_SCALE
+	cairo_surface_set_device_scale (surface, scale, scale);
+#endif
+
+	return surface;
+}
+
+void
+murrine_raster_key_init (MurrineRasterKey *key, MurrineRasterType type,
+                         int width, int height, double scale)
+{
+	memset (key, 0, sizeof (MurrineRasterKey));
+
+	key->type   = type;
+	key->width  = width;
+	key->height = height;
+#ifdef HAVE_DEVICE_SCALE
+	key->scale  = scale;
+#else
+	key->scale  = 1.0;
+#endif
+}
+
+MRN_DEFINE_KEY_HASH (murrine_raster_key, MurrineRasterKey)
+
+/* Returns a new reference to the cached surface, or NULL */
+cairo_surface_t*
+murrine_raster_cache_lookup (const MurrineRasterKey *key)
+{
+	cairo_surface_t *surface = NULL;
+
+	G_LOCK (raster_cache);
+
+	if (raster_cache)
+		surface = g_hash_table_lookup (raster_cache, key);
+	if (surface)
+		cairo_surface_reference (surface);
+
+	G_UNLOCK (raster_cache);
+
+	if (!surface)
+		MRN_TRACE_CACHE_MISS ("raster", key->width, key->height);
+
+	return surface;
+}
+
+/* The cache keeps its own reference to the surface */
+void
+murrine_raster_cache_insert (const MurrineRasterKey *key, cairo_surface_t *surface)
+{
+	gsize pixels = raster_surface_pixels (surface);
+	cairo_surface_t *old;
+
+	if (pixels > RASTER_CACHE_MAX_PIXELS / 4)
+		return;
+
+	G_LOCK (raster_cache);
+
+	if (!raster_cache)
+		raster_cache = g_hash_table_new_full (murrine_raster_key_hash,
+		                                      murrine_raster_key_equal,
+		                                      g_free, (GDestroyNotify) cairo_surface_destroy);
+
+	/* a worker may have filled in the same key meanwhile */
+	old = g_hash_table_lookup (raster_cache, key);
+	if (old)
+		raster_cache_pixels -= raster_surface_pixels (old);
+
+	if (raster_cache_pixels + pixels > RASTER_CACHE_MAX_PIXELS)
+	{
+		g_hash_table_remove_all (raster_cache);
+		raster_cache_pixels = 0;
+	}
+
+	g_hash_table_replace (raster_cache, g_memdup (key, sizeof (MurrineRasterKey)),
+	                      cairo_surface_reference (surface));
+	raster_cache_pixels += pixels;
+
+	G_UNLOCK (raster_cache);
+
+	MRN_TRACE_CACHE_FILL ("raster");
+}
+
+void
+murrine_raster_cache_clear (void)
+{
+	G_LOCK (raster_cache);
+
+	if (raster_cache)
+	{
+		g_hash_table_destroy (raster_cache);
+		raster_cache = NULL;
+	}
+
+	raster_cache_pixels = 0;
+
+	G_UNLOCK (raster_cache);
+}
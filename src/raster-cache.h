@@ -0,0 +1,61 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef RASTER_CACHE_H
+#define RASTER_CACHE_H
+
+#include <gtk/gtk.h>
+
+#include "murrine_types.h"
+
+typedef enum
+{
+	MRN_RASTER_MENU_GLOW,
+	MRN_RASTER_BLUR_GLOW,
+	MRN_RASTER_PROGRESSBAR_STROKES
+} MurrineRasterType;
+
+/* Image surfaces are created at the device scale of the target they are
+ * painted on, so the scale is part of the key and assets rendered for one
+ * monitor are kept while drawing on another. */
+typedef struct
+{
+	MurrineRasterType type;
+	int               width;
+	int               height;
+	int               param[2];
+	double            scale;
+	MurrineRGB        color[2];
+} MurrineRasterKey;
+
+G_GNUC_INTERNAL double murrine_get_device_scale (cairo_t *cr);
+
+G_GNUC_INTERNAL cairo_surface_t* murrine_raster_surface_create (int width, int height, double scale);
+
+G_GNUC_INTERNAL void murrine_raster_key_init (MurrineRasterKey *key, MurrineRasterType type,
+                                              int width, int height, double scale);
+
+G_GNUC_INTERNAL cairo_surface_t* murrine_raster_cache_lookup (const MurrineRasterKey *key);
+
+G_GNUC_INTERNAL void murrine_raster_cache_insert (const MurrineRasterKey *key, cairo_surface_t *surface);
+
+G_GNUC_INTERNAL void murrine_raster_cache_clear (void);
+
+#endif /* RASTER_CACHE_H */
@@ -0,0 +1,373 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include "rc-cache.h"
+#include "support.h"
+
+#define RC_CACHE_MAGIC   0x43435258 /* "XRCC" */
+#define RC_CACHE_VERSION 3
+
+/* The file is a header followed by the records sorted by position, each
+ * one padded to a multiple of 8 bytes. It is used in place through
+ * mmap(), so it is only valid on the machine that wrote it. */
+typedef struct
+{
+	guint32 magic;
+	guint32 version;
+	guint32 record_size;
+	guint32 n_records;
+	guint64 key;
+	guint64 layout;      /* of the records, see murrine_rc_cache_lookup () */
+} RcCacheHeader;
+
+typedef struct
+{
+	guint32 line;
+	guint32 position;
+	/* followed by record_size bytes */
+} RcCacheEntry;
+
+/* The gtkrc as stat () sees it, so that an edit, or another file moved
+ * in its place, gives another key without reading the contents */
+typedef struct
+{
+	guint64 dev;
+	guint64 ino;
+	gint64  mtime;
+	gint64  ctime;
+	gint64  size;
+	guint64 scheme_hash;
+	guint64 layout;
+} RcCacheKey;
+
+typedef struct
+{
+	gchar       *path;        /* of the cache file */
+	guint64      key;
+	guint64      layout;
+	GMappedFile *mapped;      /* NULL while there is no valid cache */
+	gsize        record_size; /* of the records in pending */
+	GArray      *pending;     /* records to write out, as RcCacheEntry + data */
+} RcCacheFile;
+
+static gint        rc_cache_enabled = -1;
+static GHashTable *rc_cache_files = NULL;
+static guint       rc_cache_flush_id = 0;
+
+static gsize
+entry_stride (gsize record_size)
+{
+	return (sizeof (RcCacheEntry) + record_size + 7) & ~(gsize) 7;
+}
+
+static GMappedFile*
+rc_cache_map (const gchar *path, guint64 key, guint64 layout)
+{
+	GMappedFile *mapped;
+	const RcCacheHeader *header;
+	gsize length;
+
+	mapped = g_mapped_file_new (path, FALSE, NULL);
+	if (!mapped)
+		return NULL;
+
+	header = (const RcCacheHeader*) g_mapped_file_get_contents (mapped);
+	length = g_mapped_file_get_length (mapped);
+
+	if (length < sizeof (RcCacheHeader) ||
+	    header->magic != RC_CACHE_MAGIC ||
+	    header->version != RC_CACHE_VERSION ||
+	    header->key != key ||
+	    header->layout != layout ||
+	    length < sizeof (RcCacheHeader) + header->n_records * entry_stride (header->record_size))
+	{
+		g_mapped_file_unref (mapped);
+		return NULL;
+	}
+
+	return mapped;
+}
+
+static void
+rc_cache_file_reset (RcCacheFile *file)
+{
+	if (file->mapped)
+	{
+		g_mapped_file_unref (file->mapped);
+		file->mapped = NULL;
+	}
+	if (file->pending)
+	{
+		g_array_free (file->pending, TRUE);
+		file->pending = NULL;
+	}
+	g_free (file->path);
+	file->path = NULL;
+}
+
+static void
+rc_cache_file_free (RcCacheFile *file)
+{
+	rc_cache_file_reset (file);
+	g_free (file);
+}
+
+/* Returns the cache of the file the scanner reads, NULL when caching is
+ * disabled or the input is not a file. The file is looked up once per
+ * scanner, that is once per gtkrc, and kept in its qdata. */
+static RcCacheFile*
+rc_cache_get_file (GScanner *scanner, GtkSettings *settings, guint64 layout)
+{
+	static RcCacheFile no_file;
+	RcCacheFile *file;
+	RcCacheKey key;
+	struct stat st;
+	gchar *scheme = NULL;
+	gchar *name;
+
+	if (rc_cache_enabled < 0)
+	{
+		const gchar *env = g_getenv ("XAMARIN_THEME_CACHE");
+
+		rc_cache_enabled = env && *env && strcmp (env, "0") != 0;
+	}
+
+	if (!rc_cache_enabled || !scanner->input_name)
+		return NULL;
+
+	file = g_datalist_get_data (&scanner->qdata, "murrine-rc-cache");
+	if (file)
+		return file != &no_file && file->layout == layout ? file : NULL;
+
+	if (g_stat (scanner->input_name, &st) != 0)
+	{
+		g_datalist_set_data (&scanner->qdata, "murrine-rc-cache", &no_file);
+		return NULL;
+	}
+
+	memset (&key, 0, sizeof (RcCacheKey));
+	key.dev = st.st_dev;
+	key.ino = st.st_ino;
+	key.mtime = st.st_mtime;
+	key.ctime = st.st_ctime;
+	key.size = st.st_size;
+	key.layout = layout;
+
+	/* symbolic colors are resolved while parsing */
+	if (settings)
+		g_object_get (settings, "gtk-color-scheme", &scheme, NULL);
+	key.scheme_hash = murrine_hash_bytes64 (MRN_HASH64_INIT, scheme, scheme ? strlen (scheme) : 0);
+	g_free (scheme);
+
+	if (!rc_cache_files)
+		rc_cache_files = g_hash_table_new_full (g_str_hash, g_str_equal,
+		                                        g_free, (GDestroyNotify) rc_cache_file_free);
+
+	file = g_hash_table_lookup (rc_cache_files, scanner->input_name);
+	if (!file)
+	{
+		file = g_new0 (RcCacheFile, 1);
+		g_hash_table_insert (rc_cache_files, g_strdup (scanner->input_name), file);
+	}
+
+	g_datalist_set_data (&scanner->qdata, "murrine-rc-cache", file);
+
+	if (file->path && file->key == murrine_hash_bytes64 (MRN_HASH64_INIT, &key, sizeof (RcCacheKey)))
+		return file;
+
+	rc_cache_file_reset (file);
+
+	file->key = murrine_hash_bytes64 (MRN_HASH64_INIT, &key, sizeof (RcCacheKey));
+	file->layout = layout;
+
+	name = g_strdup_printf ("%016" G_GINT64_MODIFIER "x.cache", file->key);
+	file->path = g_build_filename (g_get_user_cache_dir (), "xamarin", name, NULL);
+	g_free (name);
+
+	file->mapped = rc_cache_map (file->path, file->key, file->layout);
+
+	return file;
+}
+
+gboolean
+murrine_rc_cache_lookup (GScanner *scanner, GtkSettings *settings,
+                         guint line, guint position,
+                         gpointer record, gsize size, guint64 layout)
+{
+	RcCacheFile *file;
+	const RcCacheHeader *header;
+	const gchar *entries;
+	gsize stride;
+	guint lo, hi;
+
+	file = rc_cache_get_file (scanner, settings, layout);
+	if (!file || !file->mapped)
+		return FALSE;
+
+	header = (const RcCacheHeader*) g_mapped_file_get_contents (file->mapped);
+	if (header->record_size != size)
+	{
+		/* the layout does not match the size, replace it */
+		g_mapped_file_unref (file->mapped);
+		file->mapped = NULL;
+		return FALSE;
+	}
+
+	entries = (const gchar*) (header + 1);
+	stride = entry_stride (size);
+	lo = 0;
+	hi = header->n_records;
+
+	while (lo < hi)
+	{
+		guint mid = (lo + hi) / 2;
+		const RcCacheEntry *entry = (const RcCacheEntry*) (entries + mid * stride);
+
+		if (entry->line == line && entry->position == position)
+		{
+			memcpy (record, entry + 1, size);
+			return TRUE;
+		}
+
+		if (entry->line < line || (entry->line == line && entry->position < position))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return FALSE;
+}
+
+static gint
+entry_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const RcCacheEntry *ea = a, *eb = b;
+
+	if (ea->line != eb->line)
+		return ea->line < eb->line ? -1 : 1;
+	if (ea->position != eb->position)
+		return ea->position < eb->position ? -1 : 1;
+
+	return 0;
+}
+
+static void
+rc_cache_file_write (gpointer key, gpointer value, gpointer user_data)
+{
+	RcCacheFile *file = value;
+	RcCacheHeader header;
+	GString *contents;
+	gchar *dir;
+	gsize stride;
+
+	if (!file->pending || file->pending->len == 0 || !file->path)
+		return;
+
+	stride = entry_stride (file->record_size);
+	g_qsort_with_data (file->pending->data, file->pending->len / stride, stride,
+	                   entry_compare, NULL);
+
+	memset (&header, 0, sizeof (RcCacheHeader));
+	header.magic = RC_CACHE_MAGIC;
+	header.version = RC_CACHE_VERSION;
+	header.record_size = file->record_size;
+	header.n_records = file->pending->len / stride;
+	header.key = file->key;
+	header.layout = file->layout;
+
+	contents = g_string_sized_new (sizeof (RcCacheHeader) + file->pending->len);
+	g_string_append_len (contents, (const gchar*) &header, sizeof (RcCacheHeader));
+	g_string_append_len (contents, file->pending->data, file->pending->len);
+
+	dir = g_path_get_dirname (file->path);
+	if (g_mkdir_with_parents (dir, 0700) == 0 &&
+	    g_file_set_contents (file->path, contents->str, contents->len, NULL))
+		file->mapped = rc_cache_map (file->path, file->key, file->layout);
+	g_free (dir);
+
+	g_string_free (contents, TRUE);
+	g_array_free (file->pending, TRUE);
+	file->pending = NULL;
+}
+
+static gboolean
+rc_cache_flush (gpointer data)
+{
+	rc_cache_flush_id = 0;
+
+	if (rc_cache_files)
+		g_hash_table_foreach (rc_cache_files, rc_cache_file_write, NULL);
+
+	return FALSE;
+}
+
+/* Records are collected while the gtkrc is parsed and written out once
+ * the main loop is idle. Only files without a valid cache are written. */
+void
+murrine_rc_cache_store (GScanner *scanner, GtkSettings *settings,
+                        guint line, guint position,
+                        gconstpointer record, gsize size, guint64 layout)
+{
+	RcCacheFile *file;
+	RcCacheEntry *entry;
+	gsize stride;
+
+	file = rc_cache_get_file (scanner, settings, layout);
+	if (!file || file->mapped)
+		return;
+
+	if (file->pending && file->record_size != size)
+		return;
+
+	stride = entry_stride (size);
+	if (!file->pending)
+	{
+		file->pending = g_array_new (FALSE, TRUE, 1);
+		file->record_size = size;
+	}
+
+	g_array_set_size (file->pending, file->pending->len + stride);
+	entry = (RcCacheEntry*) (file->pending->data + file->pending->len - stride);
+	entry->line = line;
+	entry->position = position;
+	memcpy (entry + 1, record, size);
+
+	if (!rc_cache_flush_id)
+		rc_cache_flush_id = g_idle_add (rc_cache_flush, NULL);
+}
+
+void
+murrine_rc_cache_shutdown (void)
+{
+	if (rc_cache_flush_id)
+	{
+		g_source_remove (rc_cache_flush_id);
+		rc_cache_flush (NULL);
+	}
+
+	if (rc_cache_files)
+	{
+		g_hash_table_destroy (rc_cache_files);
+		rc_cache_files = NULL;
+	}
+}
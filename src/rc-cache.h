@@ -0,0 +1,44 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef RC_CACHE_H
+#define RC_CACHE_H
+
+#include <gtk/gtk.h>
+
+/* Options parsed from an engine block are kept in a binary file next to
+ * the other user caches, keyed by what stat () tells about the gtkrc and
+ * by the color scheme, so that later processes can load them without
+ * parsing. Blocks are identified by the position of their opening curly
+ * brace, blocks using symbolic colors are not stored since those may be
+ * defined in another gtkrc. Records are raw bytes, layout is a hash of
+ * how the caller lays them out, a cache written with another layout is
+ * not used. Enabled by setting XAMARIN_THEME_CACHE. */
+G_GNUC_INTERNAL gboolean murrine_rc_cache_lookup (GScanner *scanner, GtkSettings *settings,
+                                                  guint line, guint position,
+                                                  gpointer record, gsize size, guint64 layout);
+
+G_GNUC_INTERNAL void murrine_rc_cache_store (GScanner *scanner, GtkSettings *settings,
+                                             guint line, guint position,
+                                             gconstpointer record, gsize size, guint64 layout);
+
+G_GNUC_INTERNAL void murrine_rc_cache_shutdown (void);
+
+#endif /* RC_CACHE_H */
@@ -0,0 +1,118 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <string.h>
+#include <gio/gio.h>
+
+#include "rc-watch.h"
+#include "murrine_rc_style.h"
+
+static gint rc_watch_enabled = -1;
+
+/* filename -> GFileMonitor */
+static GHashTable *rc_watch_monitors = NULL;
+static guint rc_watch_idle_id = 0;
+
+static gboolean
+rc_watch_reload (gpointer data)
+{
+	rc_watch_idle_id = 0;
+
+	murrine_rc_style_reload ();
+
+	return FALSE;
+}
+
+static void
+rc_watch_changed (GFileMonitor      *monitor,
+                  GFile             *file,
+                  GFile             *other_file,
+                  GFileMonitorEvent  event_type,
+                  gpointer           user_data)
+{
+	if (event_type != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT &&
+	    event_type != G_FILE_MONITOR_EVENT_CREATED)
+		return;
+
+	/* editors often write a file in several steps, reload once */
+	if (rc_watch_idle_id == 0)
+		rc_watch_idle_id = g_idle_add (rc_watch_reload, NULL);
+}
+
+void
+murrine_rc_watch_add (const gchar *filename)
+{
+	GFileMonitor *monitor;
+	GFile *file;
+
+	if (rc_watch_enabled < 0)
+	{
+		const gchar *env = g_getenv ("XAMARIN_THEME_WATCH");
+
+		rc_watch_enabled = env && *env && strcmp (env, "0") != 0;
+	}
+
+	if (!rc_watch_enabled)
+		return;
+
+	if (rc_watch_monitors == NULL)
+		rc_watch_monitors = g_hash_table_new_full (g_str_hash, g_str_equal,
+		                                           g_free, g_object_unref);
+
+	if (g_hash_table_lookup (rc_watch_monitors, filename))
+		return;
+
+	file = g_file_new_for_path (filename);
+	monitor = g_file_monitor_file (file, G_FILE_MONITOR_NONE, NULL, NULL);
+	g_object_unref (file);
+
+	if (monitor == NULL)
+		return;
+
+	g_signal_connect (monitor, "changed", G_CALLBACK (rc_watch_changed), NULL);
+	g_hash_table_insert (rc_watch_monitors, g_strdup (filename), monitor);
+}
+
+void
+murrine_rc_watch_shutdown (void)
+{
+	if (rc_watch_idle_id)
+	{
+		g_source_remove (rc_watch_idle_id);
+		rc_watch_idle_id = 0;
+	}
+
+	if (rc_watch_monitors)
+	{
+		GHashTableIter iter;
+		gpointer monitor;
+
+		/* the handlers must not outlive the module */
+		g_hash_table_iter_init (&iter, rc_watch_monitors);
+		while (g_hash_table_iter_next (&iter, NULL, &monitor))
+		{
+			g_signal_handlers_disconnect_by_func (monitor, rc_watch_changed, NULL);
+			g_file_monitor_cancel (monitor);
+		}
+
+		g_hash_table_destroy (rc_watch_monitors);
+		rc_watch_monitors = NULL;
+	}
+}
@@ -0,0 +1,32 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef RC_WATCH_H
+#define RC_WATCH_H
+
+#include <gtk/gtk.h>
+
+/* With XAMARIN_THEME_WATCH set, the gtkrc files engine options are parsed
+ * from are monitored and the options reloaded when one of them changes. */
+G_GNUC_INTERNAL void murrine_rc_watch_add (const gchar *filename);
+
+G_GNUC_INTERNAL void murrine_rc_watch_shutdown (void);
+
+#endif /* RC_WATCH_H */
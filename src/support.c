@@ -438,3 +438,28 @@ murrine_get_notebook_tab_position (GtkWidget *widget,
 		}
 	}
 }
+
+guint
+murrine_hash_bytes (gconstpointer data, gsize length)
+{
+	const guchar *p = data;
+	guint32 hash = 2166136261u;
+	gsize i;
+
+	for (i = 0; i < length; i++)
+		hash = (hash ^ p[i]) * 16777619u;
+
+	return hash;
+}
+
+guint64
+murrine_hash_bytes64 (guint64 hash, gconstpointer data, gsize length)
+{
+	const guchar *p = data;
+	gsize i;
+
+	for (i = 0; i < length; i++)
+		hash = (hash ^ p[i]) * G_GUINT64_CONSTANT (1099511628211);
+
+	return hash;
+}
@@ -149,4 +149,26 @@ G_GNUC_INTERNAL void murrine_get_notebook_tab_position (GtkWidget *widget,
                                                         gboolean  *start,
                                                         gboolean  *end);
 
+/* FNV-1a over the bytes of a key. Keys are plain structs, memset before
+ * being filled in so that the padding compares equal too. */
+#define MRN_HASH64_INIT G_GUINT64_CONSTANT (14695981039346656037)
+
+G_GNUC_INTERNAL guint murrine_hash_bytes (gconstpointer data, gsize length);
+G_GNUC_INTERNAL guint64 murrine_hash_bytes64 (guint64 hash, gconstpointer data, gsize length);
+
+/* Defines prefix_hash () and prefix_equal () for a GHashTable keyed by
+ * structs of the given type */
+#define MRN_DEFINE_KEY_HASH(prefix, type) \
+static guint \
+prefix##_hash (gconstpointer v) \
+{ \
+	return murrine_hash_bytes (v, sizeof (type)); \
+} \
+\
+static gboolean \
+prefix##_equal (gconstpointer a, gconstpointer b) \
+{ \
+	return memcmp (a, b, sizeof (type)) == 0; \
+}
+
 #endif /* SUPPORT_H */
@@ -0,0 +1,37 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "trace.h"
+
+#ifdef HAVE_USDT
+/* The semaphores of the probes, in the section systemtap and bpftrace
+ * look them up in. Tracers bump them while attached to the probe. */
+#define TRACE_SEMAPHORE(name) \
+	G_GNUC_INTERNAL unsigned short xamarin_##name##_semaphore __attribute__ ((section (".probes"))) = 0
+
+TRACE_SEMAPHORE (vfunc__begin);
+TRACE_SEMAPHORE (vfunc__end);
+TRACE_SEMAPHORE (primitive__begin);
+TRACE_SEMAPHORE (primitive__end);
+TRACE_SEMAPHORE (blur__begin);
+TRACE_SEMAPHORE (blur__end);
+TRACE_SEMAPHORE (cache__miss);
+TRACE_SEMAPHORE (cache__fill);
+#endif
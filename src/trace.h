@@ -0,0 +1,109 @@
+/* Murrine theme engine
+ * Copyright (C) 2006-2007-2008-2009 Andrea Cimitan
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <glib.h>
+
+#include "config.h"
+
+/* Static probes of the xamarin provider, compiled in with --enable-usdt
+ * for perf, bpftrace or systemtap. Without a tracer attached they are a
+ * nop each. Strings are passed as pointers, sizes of -1 stand for the
+ * size of the window as in the GtkStyle vfuncs.
+ *
+ *   vfunc-begin     function, widget type, detail, width, height
+ *   vfunc-end       function, draw style used (-1 for none)
+ *   primitive-begin function, draw style, width, height
+ *   primitive-end   function
+ *   blur-begin      width, height, radius
+ *   blur-end
+ *   cache-miss      cache, width, height
+ *   cache-fill      cache
+ *
+ * A cache-fill follows a cache-miss on the same thread once the missing
+ * entry is rendered, unless it was too large to be kept.
+ *
+ * Each probe has an MRN_TRACE_*_ENABLED () test, true while a tracer is
+ * attached to it, to skip computing arguments nobody reads. The vfunc
+ * and primitive probes are only there when XAMARIN_DRAW_PROFILE is set
+ * or a tracer is attached to them before the engine is loaded, see
+ * murrine_draw_profile_install (). */
+#ifdef HAVE_USDT
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+/* defined in trace.c, tracers bump them while attached */
+G_GNUC_INTERNAL extern unsigned short xamarin_vfunc__begin_semaphore;
+G_GNUC_INTERNAL extern unsigned short xamarin_vfunc__end_semaphore;
+G_GNUC_INTERNAL extern unsigned short xamarin_primitive__begin_semaphore;
+G_GNUC_INTERNAL extern unsigned short xamarin_primitive__end_semaphore;
+G_GNUC_INTERNAL extern unsigned short xamarin_blur__begin_semaphore;
+G_GNUC_INTERNAL extern unsigned short xamarin_blur__end_semaphore;
+G_GNUC_INTERNAL extern unsigned short xamarin_cache__miss_semaphore;
+G_GNUC_INTERNAL extern unsigned short xamarin_cache__fill_semaphore;
+
+#define MRN_TRACE_VFUNC_BEGIN_ENABLED() G_UNLIKELY (xamarin_vfunc__begin_semaphore)
+#define MRN_TRACE_VFUNC_END_ENABLED() G_UNLIKELY (xamarin_vfunc__end_semaphore)
+#define MRN_TRACE_PRIMITIVE_BEGIN_ENABLED() G_UNLIKELY (xamarin_primitive__begin_semaphore)
+#define MRN_TRACE_PRIMITIVE_END_ENABLED() G_UNLIKELY (xamarin_primitive__end_semaphore)
+#define MRN_TRACE_BLUR_BEGIN_ENABLED() G_UNLIKELY (xamarin_blur__begin_semaphore)
+#define MRN_TRACE_BLUR_END_ENABLED() G_UNLIKELY (xamarin_blur__end_semaphore)
+#define MRN_TRACE_CACHE_MISS_ENABLED() G_UNLIKELY (xamarin_cache__miss_semaphore)
+#define MRN_TRACE_CACHE_FILL_ENABLED() G_UNLIKELY (xamarin_cache__fill_semaphore)
+
+#define MRN_TRACE_VFUNC_BEGIN(function, widget_type, detail, width, height) \
+	DTRACE_PROBE5 (xamarin, vfunc__begin, function, widget_type, detail, width, height)
+#define MRN_TRACE_VFUNC_END(function, style) \
+	DTRACE_PROBE2 (xamarin, vfunc__end, function, style)
+#define MRN_TRACE_PRIMITIVE_BEGIN(function, style, width, height) \
+	DTRACE_PROBE4 (xamarin, primitive__begin, function, style, width, height)
+#define MRN_TRACE_PRIMITIVE_END(function) \
+	DTRACE_PROBE1 (xamarin, primitive__end, function)
+#define MRN_TRACE_BLUR_BEGIN(width, height, radius) \
+	DTRACE_PROBE3 (xamarin, blur__begin, width, height, radius)
+#define MRN_TRACE_BLUR_END() \
+	DTRACE_PROBE (xamarin, blur__end)
+#define MRN_TRACE_CACHE_MISS(cache, width, height) \
+	DTRACE_PROBE3 (xamarin, cache__miss, cache, width, height)
+#define MRN_TRACE_CACHE_FILL(cache) \
+	DTRACE_PROBE1 (xamarin, cache__fill, cache)
+#else
+#define MRN_TRACE_VFUNC_BEGIN_ENABLED() FALSE
+#define MRN_TRACE_VFUNC_END_ENABLED() FALSE
+#define MRN_TRACE_PRIMITIVE_BEGIN_ENABLED() FALSE
+#define MRN_TRACE_PRIMITIVE_END_ENABLED() FALSE
+#define MRN_TRACE_BLUR_BEGIN_ENABLED() FALSE
+#define MRN_TRACE_BLUR_END_ENABLED() FALSE
+#define MRN_TRACE_CACHE_MISS_ENABLED() FALSE
+#define MRN_TRACE_CACHE_FILL_ENABLED() FALSE
+
+#define MRN_TRACE_VFUNC_BEGIN(function, widget_type, detail, width, height) do { } while (0)
+#define MRN_TRACE_VFUNC_END(function, style) do { } while (0)
+#define MRN_TRACE_PRIMITIVE_BEGIN(function, style, width, height) do { } while (0)
+#define MRN_TRACE_PRIMITIVE_END(function) do { } while (0)
+#define MRN_TRACE_BLUR_BEGIN(width, height, radius) do { } while (0)
+#define MRN_TRACE_BLUR_END() do { } while (0)
+#define MRN_TRACE_CACHE_MISS(cache, width, height) do { } while (0)
+#define MRN_TRACE_CACHE_FILL(cache) do { } while (0)
+#endif
+
+#endif /* TRACE_H */